@@ -3,11 +3,17 @@
 // See LICENSE for details
 
 #include "CLI.h"
+#include "Repl.h"
 #include "Runner.h"
+#include "Server.h"
+#include "codegen/LTOLinker.h"
 #include "util/MathUtils.h"
 #include "util/StringUtils.h"
 #include <llvm/Config/llvm-config.h>
 #include <llvm/Support/CommandLine.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Host.h>
+#include <iostream>
 #include <iterator>
 
 #ifdef VARUNA_DEBUG
@@ -58,7 +64,9 @@ int CLI::run()
             clEnumValN(util::OPT_O3, "O3", "Enable expensive optimizations"),
             clEnumValN(util::OPT_Os, "Os", "Enable size optimizations"),
             clEnumValN(util::OPT_Oz, "Oz",
-                       "Enable maximum size optimizations")),
+                       "Enable maximum size optimizations"),
+            clEnumValN(util::OPT_Omax, "Omax",
+                       "Enable expensive and link-time optimizations")),
         cl::cat(catCodegen));
     // Logging level
     cl::opt<spdlog::level::level_enum> logArg(
@@ -97,9 +105,9 @@ int CLI::run()
     cl::opt<std::string> outputFileArg("o", cl::desc("Output file"),
                                        cl::init(""), cl::cat(catGeneral));
     // Input files
-    cl::opt<std::string> inputFileArg(cl::desc("Input file"),
-                                      cl::value_desc("file"), cl::Positional,
-                                      cl::cat(catGeneral));
+    cl::list<std::string> inputFileArg(cl::desc("Input files"),
+                                       cl::value_desc("file"), cl::Positional,
+                                       cl::cat(catGeneral));
     // Debugging symbols
     cl::opt<bool> debugArg("g", cl::desc("Emit debugging symbols"),
                            cl::init(false), cl::cat(catCodegen));
@@ -116,13 +124,17 @@ int CLI::run()
             clEnumValN(util::EMIT_ASM, "asm", "Native assembly '.s'"),
             clEnumValN(util::EMIT_OBJ, "obj",
                        "Native object format '.o' (default)")));
-    // x86 asm syntax
+    // x86 asm syntax and target selection
+    // Rename the LLVM options that would collide with ours
     {
         auto& map = cl::getRegisteredOptions();
-        auto needle = map.find("x86-asm-syntax");
-        if(needle != map.end())
+        for(const auto name : {"x86-asm-syntax", "march", "mcpu", "mattr"})
         {
-            needle->second->setArgStr("llvm-x86-asm-syntax");
+            auto needle = map.find(name);
+            if(needle != map.end())
+            {
+                needle->second->setArgStr(fmt::format("llvm-{}", name));
+            }
         }
     }
     cl::opt<util::X86AsmSyntax> x86AsmArg(
@@ -132,6 +144,55 @@ int CLI::run()
             clEnumValN(util::X86_ATT, "att", "AT&T assembly syntax"),
             clEnumValN(util::X86_INTEL, "intel", "Intel assembly syntax")),
         cl::cat(catCodegen));
+    // Target selection
+    cl::opt<std::string> marchArg(
+        "march",
+        cl::desc("Generate code for a CPU "
+                 "('native' for the host CPU and its detected features)"),
+        cl::value_desc("cpu"), cl::init(""), cl::cat(catCodegen));
+    cl::opt<std::string> mcpuArg(
+        "mcpu",
+        cl::desc("Generate code for a CPU "
+                 "('native' for the model of the host CPU)"),
+        cl::value_desc("cpu"), cl::init(""), cl::cat(catCodegen));
+    cl::opt<std::string> mattrArg(
+        "mattr",
+        cl::desc("Enable (+) or disable (-) target features, "
+                 "e.g. '+avx2,-fma'"),
+        cl::value_desc("features"), cl::init(""), cl::cat(catCodegen));
+    // Floating-point semantics
+    cl::opt<bool> fastMathArg(
+        "ffast-math",
+        cl::desc("Allow floating-point optimizations that ignore IEEE 754 "
+                 "semantics (implies -fno-signed-zeros, -freciprocal-math "
+                 "and -ffp-contract=fast)"),
+        cl::init(false), cl::cat(catCodegen));
+    cl::opt<bool> noSignedZerosArg(
+        "fno-signed-zeros",
+        cl::desc("Ignore the sign of floating-point zeros"), cl::init(false),
+        cl::cat(catCodegen));
+    cl::opt<bool> reciprocalMathArg(
+        "freciprocal-math",
+        cl::desc("Allow replacing division with multiplication by the "
+                 "reciprocal"),
+        cl::init(false), cl::cat(catCodegen));
+    cl::opt<util::FPContract> fpContractArg(
+        "ffp-contract", cl::desc("Fusion of floating-point operations"),
+        cl::init(util::FP_CONTRACT_OFF),
+        cl::values(clEnumValN(util::FP_CONTRACT_OFF, "off",
+                              "Never fuse (default, unless -ffast-math)"),
+                   clEnumValN(util::FP_CONTRACT_FAST, "fast",
+                              "Fuse whenever profitable, e.g. into FMA")),
+        cl::cat(catCodegen));
+    // Signed integer overflow
+    cl::opt<bool> wrapvArg(
+        "fwrapv",
+        cl::desc("Make signed integer overflow wrap around in two's "
+                 "complement"),
+        cl::init(false), cl::cat(catCodegen));
+    cl::opt<bool> trapvArg(
+        "ftrapv", cl::desc("Abort the program on signed integer overflow"),
+        cl::init(false), cl::cat(catCodegen));
     // No module file
     cl::opt<bool> noModArg("no-module", cl::desc("Don't generate module file"),
                            cl::init(false), cl::cat(catGeneral));
@@ -142,6 +203,59 @@ int CLI::run()
     cl::opt<bool> stripSourceFilenameArg("strip-source-filename",
                                          cl::desc("Strip source filename"),
                                          cl::init(false), cl::cat(catCodegen));
+    // Link-time optimization
+    cl::opt<bool> fltoArg(
+        "flto", cl::desc("Emit bitcode objects for link-time optimization"),
+        cl::init(false), cl::cat(catCodegen));
+    cl::opt<bool> ltoArg(
+        "lto",
+        cl::desc("Link bitcode objects into one optimized native object"),
+        cl::init(false), cl::cat(catCodegen));
+    cl::opt<bool> thinltoArg(
+        "thinlto",
+        cl::desc("Optimize bitcode objects separately, importing functions "
+                 "across them"),
+        cl::init(false), cl::cat(catCodegen));
+    cl::opt<std::string> thinltoCacheArg(
+        "thinlto-cache-dir",
+        cl::desc("Cache directory for ThinLTO (Default: no caching)"),
+        cl::value_desc("dir"), cl::init(""), cl::cat(catCodegen));
+    // Profile-guided optimization
+    cl::opt<bool> profileGenerateArg(
+        "fprofile-generate",
+        cl::desc("Instrument the program to write a raw profile at exit"),
+        cl::init(false), cl::cat(catCodegen));
+    cl::opt<std::string> profileUseArg(
+        "fprofile-use", cl::desc("Optimize using indexed profile data"),
+        cl::value_desc("file"), cl::init(""), cl::cat(catCodegen));
+    // Bounds checking
+    cl::opt<bool> noBoundsCheckArg(
+        "fno-bounds-check",
+        cl::desc("Don't check array and slice subscripts at runtime"),
+        cl::init(false), cl::cat(catCodegen));
+    // JIT
+    cl::opt<bool> runArg(
+        "run", cl::desc("Compile the program in memory and run it"),
+        cl::init(false), cl::cat(catGeneral));
+    cl::opt<bool> replArg(
+        "repl", cl::desc("Start an interactive session"), cl::init(false),
+        cl::cat(catGeneral));
+    // Compile server
+    cl::opt<bool> serverArg(
+        "server", cl::desc("Run as a persistent compile server"),
+        cl::init(false), cl::cat(catGeneral));
+    cl::opt<bool> clientArg(
+        "client", cl::desc("Send compilation to a running compile server"),
+        cl::init(false), cl::cat(catGeneral));
+    cl::opt<bool> serverStopArg("server-stop",
+                                cl::desc("Stop a running compile server"),
+                                cl::init(false), cl::cat(catGeneral));
+    cl::opt<std::string> serverSocketArg(
+        "server-socket",
+        cl::desc(fmt::format("Compile server socket (Default: {})",
+                             Server::getDefaultSocketPath())),
+        cl::value_desc("file"), cl::init(Server::getDefaultSocketPath()),
+        cl::cat(catGeneral));
 
     {
         auto arr = std::vector<const decltype(catGeneral)*>{
@@ -156,6 +270,59 @@ int CLI::run()
     util::ProgramOptions::get().optLevel = optArg;
     util::ProgramOptions::get().loggingLevel = logArg;
 
+    // Resolve the target CPU and features,
+    // so that everything after this doesn't have to know about 'native'
+    auto setTarget = [&]() {
+        if(!marchArg.empty() && !mcpuArg.empty())
+        {
+            util::logger->error("-march and -mcpu can't be used together");
+            return false;
+        }
+
+        std::string cpu = marchArg.empty() ? mcpuArg : marchArg;
+        std::vector<std::string> features;
+        if(cpu == "native")
+        {
+            cpu = sys::getHostCPUName().str();
+            if(marchArg == "native")
+            {
+                // Features of the CPU model aren't necessarily all available,
+                // e.g. AVX on a virtual machine,
+                // so the ones reported by the host are listed explicitly
+                StringMap<bool> hostFeatures;
+                if(sys::getHostCPUFeatures(hostFeatures))
+                {
+                    for(const auto& f : hostFeatures)
+                    {
+                        features.push_back(
+                            fmt::format("{}{}", f.getValue() ? '+' : '-',
+                                        f.getKey().str()));
+                    }
+                }
+                else
+                {
+                    util::logger->warn("Failed to detect the features of "
+                                       "the host CPU '{}'",
+                                       cpu);
+                }
+            }
+        }
+        // Given last, so that they override the detected ones
+        if(!mattrArg.empty())
+        {
+            features.push_back(mattrArg);
+        }
+
+        util::ProgramOptions::get().targetCPU = cpu;
+        util::ProgramOptions::get().targetFeatures =
+            util::stringutils::join(features, ',');
+        return true;
+    };
+    if(!setTarget())
+    {
+        return -1;
+    }
+
     if(licenseArg)
     {
         // License requested, show it and quit
@@ -163,42 +330,187 @@ int CLI::run()
         return 0;
     }
 
-    if(inputFileArg.empty())
+    if(serverStopArg)
     {
-        util::logger->error("No input file given!");
-        return -1;
+        return Server::stop(serverSocketArg);
+    }
+    if(clientArg)
+    {
+        // Arguments are already validated by the parser above,
+        // so the server can parse them without failing
+        return Server::runClient(serverSocketArg,
+                                 std::vector<std::string>(argv + 1,
+                                                          argv + argc));
+    }
+
+    if(replArg)
+    {
+        const auto opt = util::ProgramOptions::view().getOptLevel();
+        Repl repl(std::get<0>(opt), std::get<1>(opt));
+        return repl.run(std::cin, std::cout);
     }
 
-    // Create Runner
     int threads = jobsArg;
     if(threads < 0)
     {
         util::logger->error("Invalid number of jobs: {}", threads);
         return -1;
     }
-    Runner runner(threads);
 
-    util::ProgramOptions::get().inputFilename = std::move(inputFileArg);
-    util::ProgramOptions::get().outputFilename = std::move(outputFileArg);
-    util::ProgramOptions::get().output = std::move(outputArg);
+    // Copy the parsed arguments into ProgramOptions and compile
+    auto compile = [&](std::shared_ptr<util::ThreadPool> pool) {
+        spdlog::set_level(logArg);
 
-    util::ProgramOptions::get().emitDebug = debugArg;
+        util::ProgramOptions::get().optLevel = optArg;
+        util::ProgramOptions::get().loggingLevel = logArg;
 
-    util::ProgramOptions::get().x86asm = x86AsmArg;
-    util::ProgramOptions::get().generateModuleFile =
-        !static_cast<bool>(noModArg);
-    util::ProgramOptions::get().stripDebug = stripDebugArg;
-    util::ProgramOptions::get().stripSourceFilename = stripSourceFilenameArg;
+        if(inputFileArg.empty())
+        {
+            util::logger->error("No input file given!");
+            return -1;
+        }
 
-    // Run it
-    if(!runner.run())
+        if(ltoArg)
+        {
+            codegen::LTOLinker linker(
+                std::vector<std::string>(inputFileArg.begin(),
+                                         inputFileArg.end()),
+                outputFileArg);
+            if(!linker.run())
+            {
+                util::logger->info("Link failed");
+                return 1;
+            }
+            util::logger->info("Link successful");
+            return 0;
+        }
+        if(thinltoArg)
+        {
+            codegen::ThinLTOLinker linker(
+                std::vector<std::string>(inputFileArg.begin(),
+                                         inputFileArg.end()),
+                pool, thinltoCacheArg);
+            if(!linker.run())
+            {
+                util::logger->info("Link failed");
+                return 1;
+            }
+            util::logger->info("Link successful");
+            return 0;
+        }
+        if(inputFileArg.size() > 1)
+        {
+            util::logger->error("Only one input file can be compiled at a "
+                                "time, use -lto or -thinlto to link multiple "
+                                "files");
+            return -1;
+        }
+
+        util::ProgramOptions::get().inputFilename = inputFileArg.front();
+        util::ProgramOptions::get().outputFilename = outputFileArg;
+        util::ProgramOptions::get().output = outputArg;
+
+        util::ProgramOptions::get().emitDebug = debugArg;
+
+        util::ProgramOptions::get().x86asm = x86AsmArg;
+        util::ProgramOptions::get().generateModuleFile =
+            !static_cast<bool>(noModArg);
+        util::ProgramOptions::get().stripDebug = stripDebugArg;
+        util::ProgramOptions::get().stripSourceFilename =
+            stripSourceFilenameArg;
+        util::ProgramOptions::get().lto = fltoArg || optArg == util::OPT_Omax;
+
+        if(profileGenerateArg && !profileUseArg.empty())
+        {
+            util::logger->error(
+                "-fprofile-generate and -fprofile-use can't be used together");
+            return -1;
+        }
+        if(!profileUseArg.empty() && !llvm::sys::fs::exists(profileUseArg))
+        {
+            util::logger->error("Profile data file '{}' not found",
+                                profileUseArg.getValue());
+            return -1;
+        }
+        util::ProgramOptions::get().profileGenerate = profileGenerateArg;
+        util::ProgramOptions::get().profileUse = profileUseArg;
+        util::ProgramOptions::get().run = runArg;
+        util::ProgramOptions::get().boundsCheck =
+            !static_cast<bool>(noBoundsCheckArg);
+        util::ProgramOptions::get().fastMath = fastMathArg;
+        util::ProgramOptions::get().noSignedZeros =
+            fastMathArg || noSignedZerosArg;
+        util::ProgramOptions::get().reciprocalMath =
+            fastMathArg || reciprocalMathArg;
+        // -ffast-math only sets the default
+        util::ProgramOptions::get().fpContract =
+            fastMathArg && fpContractArg.getNumOccurrences() == 0
+                ? util::FP_CONTRACT_FAST
+                : fpContractArg.getValue();
+        if(wrapvArg && trapvArg)
+        {
+            util::logger->error("-fwrapv and -ftrapv can't be used together");
+            return -1;
+        }
+        util::ProgramOptions::get().overflow =
+            wrapvArg ? util::OVERFLOW_WRAP
+                     : (trapvArg ? util::OVERFLOW_TRAP
+                                 : util::OVERFLOW_UNDEFINED);
+
+        // Run it
+        Runner runner(pool);
+        if(!runner.run())
+        {
+            util::logger->info("Compilation failed");
+            return 1;
+        }
+
+        util::logger->info("Compilation successful");
+        if(runArg)
+        {
+            return runner.getExitCode();
+        }
+        return 0;
+    };
+
+    if(serverArg)
     {
-        util::logger->info("Compilation failed");
-        return 1;
+        // The pool is shared by every request
+        auto pool = std::make_shared<util::ThreadPool>(threads);
+        const auto serverLogLevel = logArg.getValue();
+
+        auto handler = [&](const std::vector<std::string>& args) {
+            // Re-parse the options of the client.
+            // Requests are handled one at a time, and the worker pool is
+            // idle in between, so modifying ProgramOptions is safe here
+            std::vector<const char*> requestArgv{argv[0]};
+            for(const auto& a : args)
+            {
+                requestArgv.push_back(a.c_str());
+            }
+            cl::ResetAllOptionOccurrences();
+            // Not reset before LLVM 6,
+            // input files would accumulate over requests
+            inputFileArg.clear();
+            cl::ParseCommandLineOptions(static_cast<int>(requestArgv.size()),
+                                        requestArgv.data(), "Varuna Compiler");
+            util::ProgramOptions::get().args =
+                util::stringutils::join(args, ' ');
+            // Set on startup for everything else
+            if(!setTarget())
+            {
+                return -1;
+            }
+
+            auto ret = compile(pool);
+            spdlog::set_level(serverLogLevel);
+            return ret;
+        };
+        Server server(serverSocketArg, handler);
+        return server.run();
     }
 
-    util::logger->info("Compilation successful");
-    return 0;
+    return compile(std::make_shared<util::ThreadPool>(threads));
 }
 
 void CLI::removeRegisteredOptions()
@@ -0,0 +1,92 @@
+// Copyright (C) 2016-2017 Elias Kosunen
+// This file is distributed under the 3-Clause BSD License
+// See LICENSE for details
+
+#include "Repl.h"
+#include "util/StringUtils.h"
+
+Repl::Repl(uint8_t optLevel, uint8_t sizeLevel) : session(optLevel, sizeLevel)
+{
+}
+
+int Repl::run(std::istream& in, std::ostream& out)
+{
+    std::string input;
+    while(read(in, out, input))
+    {
+        const auto trimmed = util::stringutils::trim(input);
+        if(trimmed == ":quit" || trimmed == ":q")
+        {
+            break;
+        }
+        if(trimmed == ":help")
+        {
+            out << "Enter a function definition, a global variable, "
+                   "an import or an expression.\n"
+                   "Redefining a function replaces it.\n"
+                   ":quit to exit\n";
+            continue;
+        }
+
+        if(session.eval(input) && !session.getResult().empty())
+        {
+            out << session.getResult() << '\n';
+        }
+    }
+    return 0;
+}
+
+bool Repl::read(std::istream& in, std::ostream& out, std::string& input)
+{
+    input.clear();
+    int depth = 0;
+    do
+    {
+        out << (input.empty() ? "> " : ". ") << std::flush;
+        std::string line;
+        if(!std::getline(in, line))
+        {
+            out << '\n';
+            return !input.empty();
+        }
+
+        // Strings can't span multiple lines,
+        // so quotes only have to be tracked within one
+        char quote = 0;
+        for(size_t i = 0; i < line.size(); ++i)
+        {
+            const auto c = line[i];
+            if(quote)
+            {
+                if(c == '\\')
+                {
+                    ++i;
+                }
+                else if(c == quote)
+                {
+                    quote = 0;
+                }
+                continue;
+            }
+            if(c == '"' || c == '\'')
+            {
+                quote = c;
+            }
+            else if(c == '/' && i + 1 < line.size() && line[i + 1] == '/')
+            {
+                break;
+            }
+            else if(c == '{' || c == '(')
+            {
+                ++depth;
+            }
+            else if(c == '}' || c == ')')
+            {
+                --depth;
+            }
+        }
+
+        input.append(line).push_back('\n');
+    } while(depth > 0);
+    return true;
+}
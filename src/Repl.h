@@ -0,0 +1,46 @@
+// Copyright (C) 2016-2017 Elias Kosunen
+// This file is distributed under the 3-Clause BSD License
+// See LICENSE for details
+
+#pragma once
+
+#include "codegen/ReplSession.h"
+#include <istream>
+#include <ostream>
+#include <string>
+
+/**
+ * Interactive read-eval-print loop (`varuna -repl`).
+ * Reads top-level items and expressions, and prints the values of the
+ * expressions. An input continues on the next line
+ * until its braces and parentheses are balanced.
+ */
+class Repl final
+{
+public:
+    /**
+     * \param optLevel  Optimization level
+     * \param sizeLevel Size optimization level
+     */
+    Repl(uint8_t optLevel, uint8_t sizeLevel);
+
+    /**
+     * Run until end of input or ':quit'
+     * \param  in  Input stream
+     * \param  out Output stream for prompts and values
+     * \return     Exit code
+     */
+    int run(std::istream& in, std::ostream& out);
+
+private:
+    /**
+     * Read one input, which may span multiple lines
+     * \param  in    Input stream
+     * \param  out   Output stream for prompts
+     * \param  input Read input
+     * \return       false on end of input
+     */
+    bool read(std::istream& in, std::ostream& out, std::string& input);
+
+    codegen::ReplSession session;
+};
@@ -9,11 +9,17 @@
 #include "util/ProgramOptions.h"
 
 Runner::Runner(int threads)
-    : pool(std::make_unique<util::ThreadPool>(threads)),
+    : pool(std::make_shared<util::ThreadPool>(threads)),
       fileCache(std::make_unique<util::FileCache>())
 {
 }
 
+Runner::Runner(std::shared_ptr<util::ThreadPool> p)
+    : pool(std::move(p)), fileCache(std::make_unique<util::FileCache>())
+{
+    assert(pool);
+}
+
 bool Runner::run()
 {
     const auto& file = util::ProgramOptions::view().inputFilename;
@@ -77,7 +83,7 @@ std::future<bool> Runner::runCodegen(std::shared_ptr<ast::AST> a)
 {
     assert(a);
     auto ast = a;
-    return pool->push([ast](int) -> bool {
+    return pool->push([this, ast](int) -> bool {
         auto c = generate<codegen::Generator>(ast);
         if(!c)
         {
@@ -88,6 +94,11 @@ std::future<bool> Runner::runCodegen(std::shared_ptr<ast::AST> a)
         }
         util::logger->info("File '{}' compiled successfully",
                            ast->file->getFilename());
+        if(util::ProgramOptions::view().run)
+        {
+            exitCode = c->execute();
+            return true;
+        }
         c->write();
         return c != nullptr;
     });
@@ -12,15 +12,24 @@ class Runner
 {
 public:
     explicit Runner(int threads = 1);
+    /// Use an existing thread pool, e.g. one owned by a compile server
+    explicit Runner(std::shared_ptr<util::ThreadPool> p);
 
     bool run();
 
+    /// Return value of the program, with `-run`
+    int getExitCode() const
+    {
+        return exitCode;
+    }
+
 private:
     std::future<std::future<bool>> runFile(std::shared_ptr<util::File> f);
     std::future<bool> runCodegen(std::shared_ptr<ast::AST> a);
     std::future<bool> successTask();
     std::future<bool> failedTask();
 
-    std::unique_ptr<util::ThreadPool> pool;
+    std::shared_ptr<util::ThreadPool> pool;
     std::unique_ptr<util::FileCache> fileCache;
+    int exitCode{0};
 };
@@ -0,0 +1,322 @@
+// Copyright (C) 2016-2017 Elias Kosunen
+// This file is distributed under the 3-Clause BSD License
+// See LICENSE for details
+
+#include "Server.h"
+#include "util/Logger.h"
+#include "util/Platform.h"
+#include <llvm/Support/raw_ostream.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#if !VARUNA_WIN32
+#include <csignal>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+/// Request kinds, first element of a request message
+const std::string requestCompile = "compile";
+const std::string requestStop = "stop";
+
+#if !VARUNA_WIN32
+/// Flush everything that may have buffered output
+void flushOutput()
+{
+    util::logger->flush();
+    util::loggerBasic->flush();
+    llvm::outs().flush();
+    llvm::errs().flush();
+    std::fflush(nullptr);
+}
+
+/// Redirects stdout and stderr into a file descriptor
+/// for the lifetime of the object
+class OutputRedirect
+{
+public:
+    explicit OutputRedirect(int fd)
+        : savedOut(::dup(STDOUT_FILENO)), savedErr(::dup(STDERR_FILENO))
+    {
+        flushOutput();
+        ::dup2(fd, STDOUT_FILENO);
+        ::dup2(fd, STDERR_FILENO);
+    }
+
+    OutputRedirect(const OutputRedirect&) = delete;
+    OutputRedirect& operator=(const OutputRedirect&) = delete;
+
+    ~OutputRedirect()
+    {
+        flushOutput();
+        ::dup2(savedOut, STDOUT_FILENO);
+        ::dup2(savedErr, STDERR_FILENO);
+        ::close(savedOut);
+        ::close(savedErr);
+    }
+
+private:
+    int savedOut, savedErr;
+};
+
+/**
+ * Make sure that the directory containing the socket
+ * can't be tampered with by other users.
+ * A missing directory is created with permissions 0700
+ * \throw std::runtime_error If the directory is not safe
+ * \param path Socket filename
+ */
+void prepareSocketDirectory(const std::string& path)
+{
+    const auto slash = path.find_last_of('/');
+    std::string dir = ".";
+    if(slash != std::string::npos)
+    {
+        dir = slash == 0 ? "/" : path.substr(0, slash);
+    }
+    if(::mkdir(dir.c_str(), S_IRWXU) == -1 && errno != EEXIST)
+    {
+        throw std::runtime_error(
+            fmt::format("Failed to create socket directory '{}': {}", dir,
+                        std::strerror(errno)));
+    }
+
+    struct stat st;
+    if(::lstat(dir.c_str(), &st) == -1 || !S_ISDIR(st.st_mode) ||
+       st.st_uid != ::getuid() || (st.st_mode & (S_IWGRP | S_IWOTH)) != 0)
+    {
+        throw std::runtime_error(fmt::format(
+            "Socket directory '{}' must be a directory owned by the user "
+            "and not writable by others",
+            dir));
+    }
+}
+
+/**
+ * Connect to the server and check that it is run by the current user
+ * \throw std::runtime_error On failure
+ * \param  path Socket filename
+ * \return      Connected socket
+ */
+util::Socket connectToServer(const std::string& path)
+{
+    auto server = util::Socket::connect(path);
+    if(!server.isPeerSameUser())
+    {
+        throw std::runtime_error(fmt::format(
+            "Compile server at '{}' is run by another user", path));
+    }
+    return server;
+}
+#endif
+} // namespace
+
+Server::Server(std::string pSocketPath, Handler pHandler)
+    : socketPath(std::move(pSocketPath)), handler(std::move(pHandler))
+{
+}
+
+std::string Server::getDefaultSocketPath()
+{
+#if VARUNA_WIN32
+    return "";
+#else
+    const char* runtimeDir = std::getenv("XDG_RUNTIME_DIR");
+    if(runtimeDir && runtimeDir[0] == '/')
+    {
+        return fmt::format("{}/varuna.sock", runtimeDir);
+    }
+    return fmt::format("/tmp/varuna-{}/varuna.sock", ::getuid());
+#endif
+}
+
+#if VARUNA_WIN32
+
+int Server::run()
+{
+    util::logger->error("Compile server is not supported on Windows");
+    return -1;
+}
+
+int Server::runClient(const std::string&, const std::vector<std::string>&)
+{
+    util::logger->error("Compile server is not supported on Windows");
+    return -1;
+}
+
+int Server::stop(const std::string&)
+{
+    util::logger->error("Compile server is not supported on Windows");
+    return -1;
+}
+
+bool Server::handle(util::Socket&)
+{
+    return false;
+}
+
+#else
+
+int Server::run()
+{
+    // A client disconnecting mid-request must not kill the server
+    std::signal(SIGPIPE, SIG_IGN);
+
+    prepareSocketDirectory(socketPath);
+    auto listener = util::Socket::listen(socketPath);
+    util::logger->info("Compile server listening on '{}'", socketPath);
+
+    while(true)
+    {
+        auto client = listener.accept();
+        if(!client.isPeerSameUser())
+        {
+            util::logger->warn("Rejected connection from another user");
+            continue;
+        }
+        try
+        {
+            if(!handle(client))
+            {
+                break;
+            }
+        }
+        catch(const std::exception& e)
+        {
+            util::logger->error("Failed to handle request: '{}'", e.what());
+        }
+    }
+
+    util::logger->info("Compile server shutting down");
+    return 0;
+}
+
+bool Server::handle(util::Socket& client)
+{
+    std::vector<std::string> request;
+    if(!client.readMessage(request) || request.empty())
+    {
+        util::logger->warn("Received an invalid request");
+        return true;
+    }
+
+    if(request[0] == requestStop)
+    {
+        const int32_t ret = 0;
+        client.write(&ret, sizeof(ret));
+        return false;
+    }
+    if(request[0] != requestCompile || request.size() < 2)
+    {
+        util::logger->warn("Received an invalid request: '{}'", request[0]);
+        return true;
+    }
+
+    // request[1] is the working directory of the client,
+    // the rest are command line arguments
+    const auto cwd = util::getCurrentDirectory();
+    const auto args =
+        std::vector<std::string>(request.begin() + 2, request.end());
+    util::logger->debug("Compile request in '{}'", request[1]);
+
+    int32_t ret = -1;
+    if(::chdir(request[1].c_str()) == -1)
+    {
+        util::logger->error("Failed to change directory to '{}'", request[1]);
+    }
+    else
+    {
+        OutputRedirect redirect(client.getDescriptor());
+        try
+        {
+            ret = handler(args);
+        }
+        catch(const std::exception& e)
+        {
+            util::logger->critical("An exception occured during compilation");
+            util::logger->error("Exception message: '{}'", e.what());
+            ret = -1;
+        }
+    }
+    if(::chdir(cwd.c_str()) == -1)
+    {
+        // Every request changes into its own directory,
+        // so the next one isn't affected
+        util::logger->error("Failed to restore working directory '{}'", cwd);
+    }
+
+    // Exit code is always the last 4 bytes sent to the client
+    client.write(&ret, sizeof(ret));
+    return true;
+}
+
+int Server::runClient(const std::string& socketPath,
+                      const std::vector<std::string>& args)
+{
+    auto server = connectToServer(socketPath);
+
+    std::vector<std::string> request{requestCompile,
+                                     util::getCurrentDirectory()};
+    request.insert(request.end(), args.begin(), args.end());
+    if(!server.writeMessage(request))
+    {
+        util::logger->error("Failed to send request to '{}'", socketPath);
+        return -1;
+    }
+
+    // Forward output to stdout,
+    // holding back the last 4 bytes which contain the exit code
+    std::vector<char> pending;
+    char buf[4096];
+    while(true)
+    {
+        auto n = server.read(buf, sizeof(buf));
+        if(n <= 0)
+        {
+            break;
+        }
+        pending.insert(pending.end(), buf, buf + n);
+        if(pending.size() > sizeof(int32_t))
+        {
+            const auto len = pending.size() - sizeof(int32_t);
+            std::fwrite(pending.data(), 1, len, stdout);
+            pending.erase(pending.begin(),
+                          pending.begin() + static_cast<std::ptrdiff_t>(len));
+        }
+    }
+    std::fflush(stdout);
+
+    if(pending.size() != sizeof(int32_t))
+    {
+        util::logger->error("Connection to compile server lost");
+        return -1;
+    }
+    int32_t ret = 0;
+    std::copy(pending.begin(), pending.end(), reinterpret_cast<char*>(&ret));
+    return ret;
+}
+
+int Server::stop(const std::string& socketPath)
+{
+    auto server = connectToServer(socketPath);
+    if(!server.writeMessage({requestStop}))
+    {
+        util::logger->error("Failed to send request to '{}'", socketPath);
+        return -1;
+    }
+    int32_t ret = -1;
+    if(server.read(&ret, sizeof(ret)) != sizeof(ret))
+    {
+        return -1;
+    }
+    return ret;
+}
+
+#endif // VARUNA_WIN32
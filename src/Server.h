@@ -0,0 +1,67 @@
+// Copyright (C) 2016-2017 Elias Kosunen
+// This file is distributed under the 3-Clause BSD License
+// See LICENSE for details
+
+#pragma once
+
+#include "util/Socket.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * Persistent compile server.
+ * Listens on a local socket and runs compile requests sent by
+ * `varuna -client`, so that LLVM initialization, the worker pool and
+ * the module caches are shared between invocations.
+ *
+ * Requests are handled one at a time:
+ * ProgramOptions and the working directory are process-global.
+ */
+class Server final
+{
+public:
+    /// Compile request handler.
+    /// Receives the command line arguments of the client (without argv[0])
+    /// and returns the exit code
+    using Handler = std::function<int(const std::vector<std::string>&)>;
+
+    Server(std::string pSocketPath, Handler pHandler);
+
+    /**
+     * Run the server until a stop request is received
+     * \return Exit code
+     */
+    int run();
+
+    /**
+     * Send a compile request to a running server.
+     * Output of the compilation is written to stdout.
+     * \param  socketPath Server socket
+     * \param  args       Command line arguments
+     * \return            Exit code of the compilation
+     */
+    static int runClient(const std::string& socketPath,
+                         const std::vector<std::string>& args);
+    /**
+     * Ask a running server to shut down
+     * \param  socketPath Server socket
+     * \return            Exit code
+     */
+    static int stop(const std::string& socketPath);
+
+    /// Default socket filename: $XDG_RUNTIME_DIR/varuna.sock,
+    /// or /tmp/varuna-{uid}/varuna.sock if XDG_RUNTIME_DIR is not set
+    static std::string getDefaultSocketPath();
+
+private:
+    /**
+     * Handle a single connection
+     * \param  client Connected client
+     * \return        false if the server should stop
+     */
+    bool handle(util::Socket& client);
+
+    std::string socketPath;
+    Handler handler;
+};
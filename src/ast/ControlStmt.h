@@ -32,6 +32,7 @@ public:
     std::unique_ptr<codegen::TypedValue>
     accept(codegen::CodegenVisitor* v) override;
     void accept(ParentSolverVisitor* v, Node* p) override;
+    void accept(ReferenceVisitor* v) override;
 
     template <class Archive>
     void serialize(Archive& archive)
@@ -70,12 +71,14 @@ public:
     std::unique_ptr<codegen::TypedValue>
     accept(codegen::CodegenVisitor* v) override;
     void accept(ParentSolverVisitor* v, Node* p) override;
+    void accept(ReferenceVisitor* v) override;
 
     template <class Archive>
     void serialize(Archive& archive)
     {
         archive(cereal::base_class<Stmt>(this), CEREAL_NVP(init),
-                CEREAL_NVP(end), CEREAL_NVP(step), CEREAL_NVP(block));
+                CEREAL_NVP(end), CEREAL_NVP(step), CEREAL_NVP(block),
+                CEREAL_NVP(attributes));
     }
 
     /// init-expression: for INIT,,
@@ -86,10 +89,11 @@ public:
     std::unique_ptr<Expr> step;
     /// Loop body
     std::unique_ptr<Stmt> block;
+    /// Loop hints: @unroll(4) for
+    std::vector<Attribute> attributes;
 };
 
 /// foreach-statement
-/// Currently unused
 class ForeachStmt : public Stmt
 {
     friend class cereal::access;
@@ -99,10 +103,12 @@ class ForeachStmt : public Stmt
     }
 
 public:
-    ForeachStmt(std::unique_ptr<Expr> pIteratee,
-                std::unique_ptr<Expr> pIterator, std::unique_ptr<Stmt> pBlock)
-        : Stmt(FOREACH_STMT), iteratee(std::move(pIteratee)),
-          iterator(std::move(pIterator)), block(std::move(pBlock))
+    ForeachStmt(std::unique_ptr<IdentifierExpr> pIterator,
+                std::unique_ptr<Expr> pBegin, std::unique_ptr<Expr> pIteratee,
+                std::unique_ptr<Stmt> pBlock)
+        : Stmt(FOREACH_STMT), iterator(std::move(pIterator)),
+          begin(std::move(pBegin)), iteratee(std::move(pIteratee)),
+          block(std::move(pBlock))
     {
     }
 
@@ -110,16 +116,27 @@ public:
     std::unique_ptr<codegen::TypedValue>
     accept(codegen::CodegenVisitor* v) override;
     void accept(ParentSolverVisitor* v, Node* p) override;
+    void accept(ReferenceVisitor* v) override;
 
     template <class Archive>
     void serialize(Archive& archive)
     {
-        archive(cereal::base_class<Stmt>(this), CEREAL_NVP(iteratee),
-                CEREAL_NVP(iterator), CEREAL_NVP(block));
+        archive(cereal::base_class<Stmt>(this), CEREAL_NVP(iterator),
+                CEREAL_NVP(begin), CEREAL_NVP(iteratee), CEREAL_NVP(block),
+                CEREAL_NVP(attributes));
     }
 
-    std::unique_ptr<Expr> iteratee, iterator;
+    /// Loop variable: foreach ITERATOR in ,
+    std::unique_ptr<IdentifierExpr> iterator;
+    /// Beginning of the range: foreach in BEGIN,
+    /// EmptyExpr if not given
+    std::unique_ptr<Expr> begin;
+    /// End of the range (exclusive): foreach in ,ITERATEE
+    std::unique_ptr<Expr> iteratee;
+    /// Loop body
     std::unique_ptr<Stmt> block;
+    /// Loop hints: @unroll(4) foreach
+    std::vector<Attribute> attributes;
 };
 
 /// while-statement
@@ -142,18 +159,21 @@ public:
     std::unique_ptr<codegen::TypedValue>
     accept(codegen::CodegenVisitor* v) override;
     void accept(ParentSolverVisitor* v, Node* p) override;
+    void accept(ReferenceVisitor* v) override;
 
     template <class Archive>
     void serialize(Archive& archive)
     {
         archive(cereal::base_class<Stmt>(this), CEREAL_NVP(condition),
-                CEREAL_NVP(block));
+                CEREAL_NVP(block), CEREAL_NVP(attributes));
     }
 
     /// Condition
     std::unique_ptr<Expr> condition;
     /// Loop body
     std::unique_ptr<Stmt> block;
+    /// Loop hints: @unroll(4) while
+    std::vector<Attribute> attributes;
 };
 
 /// import-statement
@@ -186,6 +206,7 @@ public:
     std::unique_ptr<codegen::TypedValue>
     accept(codegen::CodegenVisitor* v) override;
     void accept(ParentSolverVisitor* v, Node* p) override;
+    void accept(ReferenceVisitor* v) override;
 
     template <class Archive>
     void serialize(Archive& archive)
@@ -220,6 +241,7 @@ public:
     std::unique_ptr<codegen::TypedValue>
     accept(codegen::CodegenVisitor* v) override;
     void accept(ParentSolverVisitor* v, Node* p) override;
+    void accept(ReferenceVisitor* v) override;
 
     template <class Archive>
     void serialize(Archive& archive)
@@ -164,9 +164,29 @@ void DumpVisitor::visit(IfStmt* node, size_t ind)
     log(ind + 1, "ElseBlock:");
     node->elseBlock->accept(this, ind + 2);
 }
+void DumpVisitor::dumpAttributes(const std::vector<Attribute>& attributes,
+                                 size_t ind)
+{
+    if(attributes.empty())
+    {
+        return;
+    }
+    log(ind, "Attributes:");
+    for(const auto& a : attributes)
+    {
+        std::string args;
+        for(const auto& arg : a.args)
+        {
+            args += (args.empty() ? "" : ", ") + std::to_string(arg);
+        }
+        log(ind + 1, "@{}({})", a.name, args);
+    }
+}
+
 void DumpVisitor::visit(ForStmt* node, size_t ind)
 {
     log(ind, "ForStmt:");
+    dumpAttributes(node->attributes, ind + 1);
 
     log(ind + 1, "InitExpression:");
     node->init->accept(this, ind + 2);
@@ -183,16 +203,20 @@ void DumpVisitor::visit(ForStmt* node, size_t ind)
 void DumpVisitor::visit(ForeachStmt* node, size_t ind)
 {
     log(ind, "ForeachStmt:");
-    log(ind + 1, "Iteratee:");
-    node->iteratee->accept(this, ind + 2);
+    dumpAttributes(node->attributes, ind + 1);
     log(ind + 1, "Iterator:");
     node->iterator->accept(this, ind + 2);
+    log(ind + 1, "Begin:");
+    node->begin->accept(this, ind + 2);
+    log(ind + 1, "Iteratee:");
+    node->iteratee->accept(this, ind + 2);
     log(ind + 1, "Block:");
     node->block->accept(this, ind + 2);
 }
 void DumpVisitor::visit(WhileStmt* node, size_t ind)
 {
     log(ind, "WhileStmt:");
+    dumpAttributes(node->attributes, ind + 1);
     log(ind + 1, "Condition:");
     node->condition->accept(this, ind + 2);
     log(ind + 1, "Block:");
@@ -245,6 +269,7 @@ void DumpVisitor::visit(VariableDefinitionExpr* node, size_t ind)
 void DumpVisitor::visit(GlobalVariableDefinitionExpr* node, size_t ind)
 {
     log(ind, "GlobalVariableDefinitionExpr:");
+    log(ind + 1, "Const: {}", node->isConst);
     node->var->accept(this, ind + 1);
 }
 
@@ -260,6 +285,8 @@ void DumpVisitor::visit(FunctionPrototypeStmt* node, size_t ind)
     node->name->accept(this, ind + 2);
     log(ind + 1, "FunctionReturnType:");
     node->returnType->accept(this, ind + 2);
+    log(ind + 1, "Const: {}", node->isConst);
+    dumpAttributes(node->attributes, ind + 1);
     log(ind + 1, "FunctionParameterList:");
     auto& params = node->params;
     for(auto&& p : params)
@@ -278,6 +305,7 @@ void DumpVisitor::visit(FunctionDefinitionStmt* node, size_t ind)
 void DumpVisitor::visit(ReturnStmt* node, size_t ind)
 {
     log(ind, "ReturnStmt:");
+    log(ind + 1, "TailCall: {}", node->isTailCall);
     node->returnValue->accept(this, ind + 1);
 }
 
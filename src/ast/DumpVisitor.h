@@ -7,6 +7,7 @@
 #include "ast/FwdDecl.h"
 #include "ast/Visitor.h"
 #include "util/Logger.h"
+#include <vector>
 
 namespace ast
 {
@@ -55,6 +56,8 @@ private:
     template <typename... Args>
     void log(size_t ind, const std::string& format, Args... args);
 
+    void dumpAttributes(const std::vector<Attribute>& attributes, size_t ind);
+
     std::shared_ptr<spdlog::logger> astlogger;
     bool verbose{true};
     bool useError{false};
@@ -29,6 +29,7 @@ public:
     std::unique_ptr<codegen::TypedValue>
     accept(codegen::CodegenVisitor* v) override;
     void accept(ParentSolverVisitor* v, Node* p) override;
+    void accept(ReferenceVisitor* v) override;
 
     template <class Archive>
     void serialize(Archive& archive)
@@ -54,6 +55,7 @@ public:
     std::unique_ptr<codegen::TypedValue>
     accept(codegen::CodegenVisitor* v) override;
     void accept(ParentSolverVisitor* v, Node* p) override;
+    void accept(ReferenceVisitor* v) override;
 
     template <class Archive>
     void serialize(Archive& archive)
@@ -86,6 +88,7 @@ public:
     std::unique_ptr<codegen::TypedValue>
     accept(codegen::CodegenVisitor* v) override;
     void accept(ParentSolverVisitor* v, Node* p) override;
+    void accept(ReferenceVisitor* v) override;
 
     template <class Archive>
     void serialize(Archive& archive)
@@ -128,6 +131,7 @@ public:
     std::unique_ptr<codegen::TypedValue>
     accept(codegen::CodegenVisitor* v) override;
     void accept(ParentSolverVisitor* v, Node* p) override;
+    void accept(ReferenceVisitor* v) override;
 
     template <class Archive>
     void serialize(Archive& archive)
@@ -165,6 +169,7 @@ public:
     std::unique_ptr<codegen::TypedValue>
     accept(codegen::CodegenVisitor* v) override;
     void accept(ParentSolverVisitor* v, Node* p) override;
+    void accept(ReferenceVisitor* v) override;
 
     template <class Archive>
     void serialize(Archive& archive)
@@ -215,13 +220,17 @@ public:
     std::unique_ptr<codegen::TypedValue>
     accept(codegen::CodegenVisitor* v) override;
     void accept(ParentSolverVisitor* v, Node* p) override;
+    void accept(ReferenceVisitor* v) override;
 
     template <class Archive>
     void serialize(Archive& archive)
     {
-        archive(cereal::base_class<Expr>(this), CEREAL_NVP(var));
+        archive(cereal::base_class<Expr>(this), CEREAL_NVP(var),
+                CEREAL_NVP(isConst));
     }
 
     std::unique_ptr<VariableDefinitionExpr> var;
+    /// Initializer is evaluated at compile time (`const let`)
+    bool isConst{false};
 };
 } // namespace ast
@@ -30,6 +30,7 @@ public:
     std::unique_ptr<codegen::TypedValue>
     accept(codegen::CodegenVisitor* v) override;
     void accept(ParentSolverVisitor* v, Node* p) override;
+    void accept(ReferenceVisitor* v) override;
 
     template <class Archive>
     void serialize(Archive& archive)
@@ -67,12 +68,14 @@ public:
     std::unique_ptr<codegen::TypedValue>
     accept(codegen::CodegenVisitor* v) override;
     void accept(ParentSolverVisitor* v, Node* p) override;
+    void accept(ReferenceVisitor* v) override;
 
     template <class Archive>
     void serialize(Archive& archive)
     {
         archive(cereal::base_class<Stmt>(this), CEREAL_NVP(name),
-                CEREAL_NVP(returnType), CEREAL_NVP(params), CEREAL_NVP(isMain));
+                CEREAL_NVP(returnType), CEREAL_NVP(params), CEREAL_NVP(isMain),
+                CEREAL_NVP(isConst), CEREAL_NVP(attributes));
     }
 
     /// Function name
@@ -85,6 +88,10 @@ public:
     bool isMain{false};
     /// Mangle function name
     bool mangle{true};
+    /// Function can be evaluated at compile time (`const def`)
+    bool isConst{false};
+    /// Function attributes, e.g. `@inline`
+    std::vector<Attribute> attributes;
 };
 
 /// Function definition
@@ -115,6 +122,7 @@ public:
     std::unique_ptr<codegen::TypedValue>
     accept(codegen::CodegenVisitor* v) override;
     void accept(ParentSolverVisitor* v, Node* p) override;
+    void accept(ReferenceVisitor* v) override;
 
     template <class Archive>
     void serialize(Archive& archive)
@@ -132,7 +140,7 @@ public:
     bool isDecl{false};
 };
 
-/// return-statement
+/// return-statement, or become-statement
 class ReturnStmt : public Stmt
 {
     friend class cereal::access;
@@ -142,8 +150,9 @@ class ReturnStmt : public Stmt
     }
 
 public:
-    explicit ReturnStmt(std::unique_ptr<Expr> retval)
-        : Stmt(RETURN_STMT), returnValue(std::move(retval))
+    explicit ReturnStmt(std::unique_ptr<Expr> retval, bool pIsTailCall = false)
+        : Stmt(RETURN_STMT), returnValue(std::move(retval)),
+          isTailCall(pIsTailCall)
     {
     }
 
@@ -151,14 +160,18 @@ public:
     std::unique_ptr<codegen::TypedValue>
     accept(codegen::CodegenVisitor* v) override;
     void accept(ParentSolverVisitor* v, Node* p) override;
+    void accept(ReferenceVisitor* v) override;
 
     template <class Archive>
     void serialize(Archive& archive)
     {
-        archive(cereal::base_class<Stmt>(this), CEREAL_NVP(returnValue));
+        archive(cereal::base_class<Stmt>(this), CEREAL_NVP(returnValue),
+                CEREAL_NVP(isTailCall));
     }
 
     /// Return value
     std::unique_ptr<Expr> returnValue;
+    /// `become f(...)`: the call has to be a guaranteed tail call
+    bool isTailCall{false};
 };
 } // namespace ast
@@ -31,6 +31,7 @@ class VariableDefinitionExpr;
 class GlobalVariableDefinitionExpr;
 
 class Stmt;
+struct Attribute;
 class AliasStmt;
 class BlockStmt;
 class EmptyStmt;
@@ -49,6 +50,7 @@ class ExprStmt;
 class Visitor;
 class DumpVisitor;
 class ParentSolverVisitor;
+class ReferenceVisitor;
 class Serializer;
 } // namespace ast
 
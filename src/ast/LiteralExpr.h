@@ -32,6 +32,7 @@ public:
     std::unique_ptr<codegen::TypedValue>
     accept(codegen::CodegenVisitor* v) override;
     void accept(ParentSolverVisitor* v, Node* p) override;
+    void accept(ReferenceVisitor* v) override;
 
     template <class Archive>
     void serialize(Archive& archive)
@@ -67,6 +68,7 @@ public:
     std::unique_ptr<codegen::TypedValue>
     accept(codegen::CodegenVisitor* v) override;
     void accept(ParentSolverVisitor* v, Node* p) override;
+    void accept(ReferenceVisitor* v) override;
 
     template <class Archive>
     void serialize(Archive& archive)
@@ -101,6 +103,7 @@ public:
     std::unique_ptr<codegen::TypedValue>
     accept(codegen::CodegenVisitor* v) override;
     void accept(ParentSolverVisitor* v, Node* p) override;
+    void accept(ReferenceVisitor* v) override;
 
     template <class Archive>
     void serialize(Archive& archive)
@@ -134,6 +137,7 @@ public:
     std::unique_ptr<codegen::TypedValue>
     accept(codegen::CodegenVisitor* v) override;
     void accept(ParentSolverVisitor* v, Node* p) override;
+    void accept(ReferenceVisitor* v) override;
 
     template <class Archive>
     void serialize(Archive& archive)
@@ -168,6 +172,7 @@ public:
     std::unique_ptr<codegen::TypedValue>
     accept(codegen::CodegenVisitor* v) override;
     void accept(ParentSolverVisitor* v, Node* p) override;
+    void accept(ReferenceVisitor* v) override;
 
     template <class Archive>
     void serialize(Archive& archive)
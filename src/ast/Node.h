@@ -76,6 +76,7 @@ public:
 
     virtual void accept(DumpVisitor* v, size_t ind = 0) = 0;
     virtual void accept(ParentSolverVisitor* v, Node* p) = 0;
+    virtual void accept(ReferenceVisitor* v) = 0;
     virtual std::unique_ptr<codegen::TypedValue>
     accept(codegen::CodegenVisitor* v) = 0;
 
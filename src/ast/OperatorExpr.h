@@ -31,6 +31,7 @@ public:
     std::unique_ptr<codegen::TypedValue>
     accept(codegen::CodegenVisitor* v) override;
     void accept(ParentSolverVisitor* v, Node* p) override;
+    void accept(ReferenceVisitor* v) override;
 
     template <class Archive>
     void serialize(Archive& archive)
@@ -66,6 +67,7 @@ public:
     std::unique_ptr<codegen::TypedValue>
     accept(codegen::CodegenVisitor* v) override;
     void accept(ParentSolverVisitor* v, Node* p) override;
+    void accept(ReferenceVisitor* v) override;
 
     template <class Archive>
     void serialize(Archive& archive)
@@ -100,6 +102,7 @@ public:
     std::unique_ptr<codegen::TypedValue>
     accept(codegen::CodegenVisitor* v) override;
     void accept(ParentSolverVisitor* v, Node* p) override;
+    void accept(ReferenceVisitor* v) override;
 
     template <class Archive>
     void serialize(Archive& archive)
@@ -136,6 +139,7 @@ public:
     std::unique_ptr<codegen::TypedValue>
     accept(codegen::CodegenVisitor* v) override;
     void accept(ParentSolverVisitor* v, Node* p) override;
+    void accept(ReferenceVisitor* v) override;
 
     template <class Archive>
     void serialize(Archive& archive)
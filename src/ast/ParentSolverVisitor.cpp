@@ -48,8 +48,9 @@ void ParentSolverVisitor::visit(ForeachStmt* node, Node* parent)
 {
     node->parent = parent;
 
-    node->iteratee->accept(this, node);
     node->iterator->accept(this, node);
+    node->begin->accept(this, node);
+    node->iteratee->accept(this, node);
     node->block->accept(this, node);
 }
 void ParentSolverVisitor::visit(WhileStmt* node, Node* parent)
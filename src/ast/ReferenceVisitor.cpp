@@ -0,0 +1,294 @@
+// Copyright (C) 2016-2017 Elias Kosunen
+// This file is distributed under the 3-Clause BSD License
+// See LICENSE for details
+
+#include "ast/ReferenceVisitor.h"
+#include "ast/ControlStmt.h"
+#include "ast/Expr.h"
+#include "ast/FunctionStmt.h"
+#include "ast/FwdDecl.h"
+#include "ast/LiteralExpr.h"
+#include "ast/Node.h"
+#include "ast/OperatorExpr.h"
+#include "ast/Stmt.h"
+
+namespace ast
+{
+void ReferenceVisitor::visit(Node* node)
+{
+    static_cast<void>(node);
+}
+void ReferenceVisitor::visit(Stmt* node)
+{
+    static_cast<void>(node);
+}
+void ReferenceVisitor::visit(Expr* node)
+{
+    static_cast<void>(node);
+}
+
+void ReferenceVisitor::visit(IfStmt* node)
+{
+    node->condition->accept(this);
+    node->ifBlock->accept(this);
+    node->elseBlock->accept(this);
+}
+void ReferenceVisitor::visit(ForStmt* node)
+{
+    node->init->accept(this);
+    node->end->accept(this);
+    node->step->accept(this);
+    node->block->accept(this);
+}
+void ReferenceVisitor::visit(ForeachStmt* node)
+{
+    node->begin->accept(this);
+    node->iteratee->accept(this);
+    node->block->accept(this);
+}
+void ReferenceVisitor::visit(WhileStmt* node)
+{
+    node->condition->accept(this);
+    node->block->accept(this);
+}
+void ReferenceVisitor::visit(ImportStmt* node)
+{
+    static_cast<void>(node);
+}
+void ReferenceVisitor::visit(ModuleStmt* node)
+{
+    static_cast<void>(node);
+}
+
+void ReferenceVisitor::visit(EmptyExpr* node)
+{
+    static_cast<void>(node);
+}
+void ReferenceVisitor::visit(IdentifierExpr* node)
+{
+    names.insert(node->value);
+}
+void ReferenceVisitor::visit(VariableRefExpr* node)
+{
+    names.insert(node->value);
+}
+void ReferenceVisitor::visit(VariableDefinitionExpr* node)
+{
+    node->init->accept(this);
+}
+void ReferenceVisitor::visit(GlobalVariableDefinitionExpr* node)
+{
+    node->var->accept(this);
+}
+
+void ReferenceVisitor::visit(FunctionParameter* node)
+{
+    node->var->accept(this);
+}
+void ReferenceVisitor::visit(FunctionPrototypeStmt* node)
+{
+    for(auto& p : node->params)
+    {
+        p->accept(this);
+    }
+}
+void ReferenceVisitor::visit(FunctionDefinitionStmt* node)
+{
+    node->proto->accept(this);
+    node->body->accept(this);
+}
+void ReferenceVisitor::visit(ReturnStmt* node)
+{
+    node->returnValue->accept(this);
+}
+
+void ReferenceVisitor::visit(IntegerLiteralExpr* node)
+{
+    static_cast<void>(node);
+}
+void ReferenceVisitor::visit(FloatLiteralExpr* node)
+{
+    static_cast<void>(node);
+}
+void ReferenceVisitor::visit(StringLiteralExpr* node)
+{
+    static_cast<void>(node);
+}
+void ReferenceVisitor::visit(CharLiteralExpr* node)
+{
+    static_cast<void>(node);
+}
+void ReferenceVisitor::visit(BoolLiteralExpr* node)
+{
+    static_cast<void>(node);
+}
+
+void ReferenceVisitor::visit(BinaryExpr* node)
+{
+    node->lhs->accept(this);
+    node->rhs->accept(this);
+}
+void ReferenceVisitor::visit(UnaryExpr* node)
+{
+    node->operand->accept(this);
+}
+void ReferenceVisitor::visit(AssignmentExpr* node)
+{
+    node->lhs->accept(this);
+    node->rhs->accept(this);
+}
+void ReferenceVisitor::visit(ArbitraryOperandExpr* node)
+{
+    for(auto& o : node->operands)
+    {
+        o->accept(this);
+    }
+}
+
+void ReferenceVisitor::visit(EmptyStmt* node)
+{
+    static_cast<void>(node);
+}
+void ReferenceVisitor::visit(BlockStmt* node)
+{
+    for(auto& n : node->nodes)
+    {
+        n->accept(this);
+    }
+}
+void ReferenceVisitor::visit(ExprStmt* node)
+{
+    node->expr->accept(this);
+}
+void ReferenceVisitor::visit(AliasStmt* node)
+{
+    static_cast<void>(node);
+}
+
+void Expr::accept(ast::ReferenceVisitor* v)
+{
+    return v->visit(this);
+}
+void Stmt::accept(ast::ReferenceVisitor* v)
+{
+    return v->visit(this);
+}
+
+void IfStmt::accept(ast::ReferenceVisitor* v)
+{
+    return v->visit(this);
+}
+void ForStmt::accept(ast::ReferenceVisitor* v)
+{
+    return v->visit(this);
+}
+void ForeachStmt::accept(ast::ReferenceVisitor* v)
+{
+    return v->visit(this);
+}
+void WhileStmt::accept(ast::ReferenceVisitor* v)
+{
+    return v->visit(this);
+}
+void ImportStmt::accept(ast::ReferenceVisitor* v)
+{
+    return v->visit(this);
+}
+void ModuleStmt::accept(ast::ReferenceVisitor* v)
+{
+    return v->visit(this);
+}
+
+void EmptyExpr::accept(ast::ReferenceVisitor* v)
+{
+    return v->visit(this);
+}
+void IdentifierExpr::accept(ast::ReferenceVisitor* v)
+{
+    return v->visit(this);
+}
+void VariableRefExpr::accept(ast::ReferenceVisitor* v)
+{
+    return v->visit(this);
+}
+void VariableDefinitionExpr::accept(ast::ReferenceVisitor* v)
+{
+    return v->visit(this);
+}
+void GlobalVariableDefinitionExpr::accept(ast::ReferenceVisitor* v)
+{
+    return v->visit(this);
+}
+
+void FunctionParameter::accept(ast::ReferenceVisitor* v)
+{
+    return v->visit(this);
+}
+void FunctionPrototypeStmt::accept(ast::ReferenceVisitor* v)
+{
+    return v->visit(this);
+}
+void FunctionDefinitionStmt::accept(ast::ReferenceVisitor* v)
+{
+    return v->visit(this);
+}
+void ReturnStmt::accept(ast::ReferenceVisitor* v)
+{
+    return v->visit(this);
+}
+
+void IntegerLiteralExpr::accept(ast::ReferenceVisitor* v)
+{
+    return v->visit(this);
+}
+void FloatLiteralExpr::accept(ast::ReferenceVisitor* v)
+{
+    return v->visit(this);
+}
+void StringLiteralExpr::accept(ast::ReferenceVisitor* v)
+{
+    return v->visit(this);
+}
+void CharLiteralExpr::accept(ast::ReferenceVisitor* v)
+{
+    return v->visit(this);
+}
+void BoolLiteralExpr::accept(ast::ReferenceVisitor* v)
+{
+    return v->visit(this);
+}
+
+void BinaryExpr::accept(ast::ReferenceVisitor* v)
+{
+    return v->visit(this);
+}
+void UnaryExpr::accept(ast::ReferenceVisitor* v)
+{
+    return v->visit(this);
+}
+void AssignmentExpr::accept(ast::ReferenceVisitor* v)
+{
+    return v->visit(this);
+}
+void ArbitraryOperandExpr::accept(ast::ReferenceVisitor* v)
+{
+    return v->visit(this);
+}
+
+void EmptyStmt::accept(ast::ReferenceVisitor* v)
+{
+    return v->visit(this);
+}
+void BlockStmt::accept(ast::ReferenceVisitor* v)
+{
+    return v->visit(this);
+}
+void ExprStmt::accept(ast::ReferenceVisitor* v)
+{
+    return v->visit(this);
+}
+void AliasStmt::accept(ast::ReferenceVisitor* v)
+{
+    return v->visit(this);
+}
+} // namespace ast
@@ -0,0 +1,82 @@
+// Copyright (C) 2016-2017 Elias Kosunen
+// This file is distributed under the 3-Clause BSD License
+// See LICENSE for details
+
+#pragma once
+
+#include "ast/FwdDecl.h"
+#include "ast/Node.h"
+#include "ast/Visitor.h"
+#include <string>
+#include <unordered_set>
+
+namespace ast
+{
+/**
+ * Collects the names referred to in a subtree:
+ * variables, called functions and subscripted arrays.
+ *
+ * Names are not resolved, so a local variable shadowing a global symbol
+ * counts as a reference to the global one.
+ * Names of types, and the names being defined, are not collected
+ */
+class ReferenceVisitor final : public Visitor
+{
+public:
+    ReferenceVisitor() = default;
+
+    /**
+     * Run the visitor
+     * \param root Pointer to Node or similar, root node of the subtree
+     * \return     Names referred to in the subtree
+     */
+    template <typename T>
+    std::unordered_set<std::string> run(T* root)
+    {
+        names.clear();
+        root->accept(this);
+        return std::move(names);
+    }
+
+    void visit(Node* node);
+    void visit(Stmt* node);
+    void visit(Expr* node);
+
+    void visit(IfStmt* node);
+    void visit(ForStmt* node);
+    void visit(ForeachStmt* node);
+    void visit(WhileStmt* node);
+    void visit(ImportStmt* node);
+    void visit(ModuleStmt* node);
+
+    void visit(EmptyExpr* node);
+    void visit(IdentifierExpr* node);
+    void visit(VariableRefExpr* node);
+    void visit(VariableDefinitionExpr* node);
+    void visit(GlobalVariableDefinitionExpr* node);
+
+    void visit(FunctionParameter* node);
+    void visit(FunctionPrototypeStmt* node);
+    void visit(FunctionDefinitionStmt* node);
+    void visit(ReturnStmt* node);
+
+    void visit(IntegerLiteralExpr* node);
+    void visit(FloatLiteralExpr* node);
+    void visit(StringLiteralExpr* node);
+    void visit(CharLiteralExpr* node);
+    void visit(BoolLiteralExpr* node);
+
+    void visit(BinaryExpr* node);
+    void visit(UnaryExpr* node);
+    void visit(AssignmentExpr* node);
+    void visit(ArbitraryOperandExpr* node);
+
+    void visit(EmptyStmt* node);
+    void visit(BlockStmt* node);
+    void visit(ExprStmt* node);
+    void visit(AliasStmt* node);
+
+private:
+    std::unordered_set<std::string> names;
+};
+} // namespace ast
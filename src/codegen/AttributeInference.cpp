@@ -0,0 +1,250 @@
+// Copyright (C) 2016-2017 Elias Kosunen
+// This file is distributed under the 3-Clause BSD License
+// See LICENSE for details
+
+#include "codegen/AttributeInference.h"
+#include <llvm/Analysis/ValueTracking.h>
+#include <llvm/IR/Instructions.h>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace codegen
+{
+namespace inference
+{
+namespace
+{
+/// Is the memory a local variable, or a constant global
+bool isUnobservable(const llvm::Value* ptr, const llvm::DataLayout& dl)
+{
+    auto obj = llvm::GetUnderlyingObject(const_cast<llvm::Value*>(ptr), dl);
+    if(llvm::isa<llvm::AllocaInst>(obj))
+    {
+        return true;
+    }
+    auto g = llvm::dyn_cast<llvm::GlobalVariable>(obj);
+    return g && g->isConstant();
+}
+
+/// Memory access allowed by the attributes of a function
+uint32_t getAllowedAccess(const llvm::Function& f)
+{
+    if(f.doesNotAccessMemory())
+    {
+        return ACCESS_NONE;
+    }
+    if(f.onlyReadsMemory())
+    {
+        return ACCESS_READ;
+    }
+    return ACCESS_READ | ACCESS_WRITE;
+}
+} // namespace
+
+uint32_t getMemoryAccess(const llvm::Instruction& inst)
+{
+    const auto& dl = inst.getModule()->getDataLayout();
+    if(auto store = llvm::dyn_cast<llvm::StoreInst>(&inst))
+    {
+        return isUnobservable(store->getPointerOperand(), dl) ? ACCESS_NONE
+                                                              : ACCESS_WRITE;
+    }
+    if(auto load = llvm::dyn_cast<llvm::LoadInst>(&inst))
+    {
+        return isUnobservable(load->getPointerOperand(), dl) ? ACCESS_NONE
+                                                             : ACCESS_READ;
+    }
+    if(auto call = llvm::dyn_cast<llvm::CallInst>(&inst))
+    {
+        if(call->doesNotAccessMemory())
+        {
+            return ACCESS_NONE;
+        }
+        if(call->onlyReadsMemory())
+        {
+            return ACCESS_READ;
+        }
+        return ACCESS_READ | ACCESS_WRITE;
+    }
+
+    uint32_t access = ACCESS_NONE;
+    if(inst.mayReadFromMemory())
+    {
+        access |= ACCESS_READ;
+    }
+    if(inst.mayWriteToMemory())
+    {
+        access |= ACCESS_WRITE;
+    }
+    return access;
+}
+
+void inferAttributes(llvm::Module& m)
+{
+    std::vector<llvm::Function*> defined;
+    for(auto& f : m)
+    {
+        if(!f.isDeclaration())
+        {
+            defined.push_back(&f);
+        }
+    }
+
+    for(auto f : defined)
+    {
+        f->addFnAttr(llvm::Attribute::NoUnwind);
+    }
+
+    // Memory access of functions calling each other depend on each other.
+    // Start by assuming that no memory is accessed, and iterate until
+    // nothing changes, so that recursive functions don't access memory
+    // just because they call themselves
+    std::unordered_map<const llvm::Function*, uint32_t> access;
+    for(auto f : defined)
+    {
+        access[f] = ACCESS_NONE;
+    }
+    for(bool changed = true; changed;)
+    {
+        changed = false;
+        for(auto f : defined)
+        {
+            auto& a = access[f];
+            const auto old = a;
+            for(const auto& bb : *f)
+            {
+                for(const auto& inst : bb)
+                {
+                    auto call = llvm::dyn_cast<llvm::CallInst>(&inst);
+                    auto callee = call ? call->getCalledFunction() : nullptr;
+                    if(callee && access.count(callee) != 0)
+                    {
+                        a |= access[callee] & getAllowedAccess(*callee);
+                    }
+                    else
+                    {
+                        a |= getMemoryAccess(inst);
+                    }
+                }
+            }
+            changed |= a != old;
+        }
+    }
+    for(auto f : defined)
+    {
+        if(f->doesNotAccessMemory())
+        {
+            continue;
+        }
+        const auto a = access[f];
+        if(a == ACCESS_NONE)
+        {
+            f->removeFnAttr(llvm::Attribute::ReadOnly);
+            f->addFnAttr(llvm::Attribute::ReadNone);
+        }
+        else if(a == ACCESS_READ)
+        {
+            f->addFnAttr(llvm::Attribute::ReadOnly);
+        }
+    }
+
+    // A function doesn't recurse, if it only calls functions
+    // that don't recurse, other than itself
+    std::unordered_set<const llvm::Function*> norecurse;
+    for(bool changed = true; changed;)
+    {
+        changed = false;
+        for(auto f : defined)
+        {
+            if(norecurse.count(f) != 0)
+            {
+                continue;
+            }
+            bool recurses = false;
+            for(const auto& bb : *f)
+            {
+                for(const auto& inst : bb)
+                {
+                    auto call = llvm::dyn_cast<llvm::CallInst>(&inst);
+                    if(!call)
+                    {
+                        continue;
+                    }
+                    auto callee = call->getCalledFunction();
+                    if(!callee || callee == f ||
+                       (!callee->isIntrinsic() && !callee->doesNotRecurse() &&
+                        norecurse.count(callee) == 0))
+                    {
+                        recurses = true;
+                        break;
+                    }
+                }
+                if(recurses)
+                {
+                    break;
+                }
+            }
+            if(!recurses)
+            {
+                f->addFnAttr(llvm::Attribute::NoRecurse);
+                norecurse.insert(f);
+                changed = true;
+            }
+        }
+    }
+
+    // Internal functions are only called directly from this module,
+    // unless their address is taken
+    std::unordered_set<llvm::Function*> fast;
+    for(auto f : defined)
+    {
+        if(f->hasLocalLinkage() && !f->hasAddressTaken())
+        {
+            fast.insert(f);
+        }
+    }
+    // The caller and the callee of a `musttail` call (`become`)
+    // have to keep using the same calling convention
+    for(bool changed = true; changed;)
+    {
+        changed = false;
+        for(auto f : defined)
+        {
+            for(auto& bb : *f)
+            {
+                for(auto& inst : bb)
+                {
+                    auto call = llvm::dyn_cast<llvm::CallInst>(&inst);
+                    if(!call || !call->isMustTailCall())
+                    {
+                        continue;
+                    }
+                    auto callee = call->getCalledFunction();
+                    if(fast.count(f) != fast.count(callee))
+                    {
+                        fast.erase(f);
+                        fast.erase(callee);
+                        changed = true;
+                    }
+                }
+            }
+        }
+    }
+    for(auto f : defined)
+    {
+        if(fast.count(f) == 0)
+        {
+            continue;
+        }
+        f->setCallingConv(llvm::CallingConv::Fast);
+        f->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
+        for(auto user : f->users())
+        {
+            llvm::cast<llvm::CallInst>(user)->setCallingConv(
+                llvm::CallingConv::Fast);
+        }
+    }
+}
+} // namespace inference
+} // namespace codegen
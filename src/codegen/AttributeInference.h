@@ -0,0 +1,50 @@
+// Copyright (C) 2016-2017 Elias Kosunen
+// This file is distributed under the 3-Clause BSD License
+// See LICENSE for details
+
+#pragma once
+
+#include <llvm/IR/Instruction.h>
+#include <llvm/IR/Module.h>
+
+namespace codegen
+{
+/**
+ * Inference of LLVM function attributes from the generated code,
+ * so that the optimizer doesn't have to rediscover them
+ */
+namespace inference
+{
+/// Memory accessed by an instruction, a bitmask
+enum MemoryAccess : uint32_t
+{
+    ACCESS_NONE = 0,
+    ACCESS_READ = 1 << 0,
+    ACCESS_WRITE = 1 << 1
+};
+
+/**
+ * Get the memory accessed by an instruction.
+ * Local variables and constant globals aren't counted.
+ * Calls access the memory their callee is allowed to access,
+ * according to its attributes.
+ * \param  inst Instruction
+ * \return      Bitmask of MemoryAccess
+ */
+uint32_t getMemoryAccess(const llvm::Instruction& inst);
+
+/**
+ * Infer attributes for the functions defined in a module:
+ *  - every function is `nounwind`, since there are no exceptions
+ *  - `readnone` and `readonly` from the memory accessed by the function
+ *    and its callees
+ *  - `norecurse` if the function doesn't call itself, directly or through
+ *    other functions
+ *  - internal functions whose address isn't taken use the `fastcc`
+ *    calling convention and are `unnamed_addr`, unless they're the caller
+ *    or the callee of a `musttail` call with a function that can't
+ * \param m Module
+ */
+void inferAttributes(llvm::Module& m);
+} // namespace inference
+} // namespace codegen
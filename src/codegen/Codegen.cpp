@@ -3,13 +3,51 @@
 // See LICENSE for details
 
 #include "codegen/Codegen.h"
+#include "codegen/FunctionImport.h"
+#include "codegen/JIT.h"
+#include "codegen/ModuleSummary.h"
 #include "util/Process.h"
 #include "util/ProgramInfo.h"
 #include "util/ProgramOptions.h"
 #include "util/StringUtils.h"
+#include <llvm/IRReader/IRReader.h>
 #include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Host.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/Support/TargetRegistry.h>
 #include <llvm/Support/TargetSelect.h>
+#include <llvm/Target/TargetMachine.h>
 #include <fstream>
+#include <unordered_set>
+
+#if VARUNA_LLVM_VERSION == 39
+#include <llvm/Bitcode/ReaderWriter.h>
+#else
+#include <llvm/Bitcode/BitcodeWriter.h>
+#endif
+
+namespace
+{
+/// Maximum number of instructions in an exported function
+/// for its body to be embedded in the module file
+constexpr size_t inlineBodyThreshold = 32;
+
+/// Target CPU and feature flags for opt and llc, empty if none were given
+std::string getTargetFlags()
+{
+    const auto& options = util::ProgramOptions::view();
+    std::string flags;
+    if(!options.targetCPU.empty())
+    {
+        flags += fmt::format(" -mcpu={}", options.targetCPU);
+    }
+    if(!options.targetFeatures.empty())
+    {
+        flags += fmt::format(" -mattr={}", options.targetFeatures);
+    }
+    return flags;
+}
+} // namespace
 
 namespace codegen
 {
@@ -41,29 +79,89 @@ bool Codegen::run()
     {
         return false;
     }
-    return finish();
+    if(util::ProgramOptions::view().run)
+    {
+        // Optimized by the JIT in execute(),
+        // without writing anything
+        return true;
+    }
+    if(!finish())
+    {
+        return false;
+    }
+
+    // Written after optimization,
+    // so that the module file can carry optimized function bodies
+    if(util::ProgramOptions::view().outputFilename == "-" ||
+       !util::ProgramOptions::view().generateModuleFile)
+    {
+        util::logger->info("Not writing module export file");
+        return true;
+    }
+    // Unoptimized bodies aren't worth inlining
+    codegen->writeModuleFile(info.optEnabled() ? extractInlineBodies() : "");
+    return true;
 }
 
 bool Codegen::prepare()
 {
     // Initialize LLVM stuff
-    // For some reason all of these return false
-    if(!llvm::InitializeNativeTarget())
+    // Only done once per process,
+    // so that a compile server does not repeat it for every request
+    static const bool initialized = []() {
+        // For some reason all of these return false
+        if(!llvm::InitializeNativeTarget())
+        {
+            util::logger->debug("LLVM native target init failed");
+            // return false;
+        }
+        if(!llvm::InitializeNativeTargetAsmPrinter())
+        {
+            util::logger->debug(
+                "LLVM native target assembly printer init failed");
+            // return false;
+        }
+        if(!llvm::InitializeNativeTargetAsmParser())
+        {
+            util::logger->debug(
+                "LLVM native target assembly parser init failed");
+            // return false;
+        }
+        return true;
+    }();
+
+    if(!initialized)
     {
-        util::logger->debug("LLVM native target init failed");
-        // return false;
+        return false;
     }
-    if(!llvm::InitializeNativeTargetAsmPrinter())
+
+    // The optimizer only knows about the target CPU and its features
+    // (vector widths, costs of instructions) if the module has a target.
+    // Without -march, -mcpu or -mattr the module is left target-independent
+    const auto& options = util::ProgramOptions::view();
+    if(options.targetCPU.empty() && options.targetFeatures.empty())
     {
-        util::logger->debug("LLVM native target assembly printer init failed");
-        // return false;
+        return true;
     }
-    if(!llvm::InitializeNativeTargetAsmParser())
+    const auto triple = llvm::sys::getDefaultTargetTriple();
+    std::string err;
+    auto target = llvm::TargetRegistry::lookupTarget(triple, err);
+    if(!target)
     {
-        util::logger->debug("LLVM native target assembly parser init failed");
-        // return false;
+        util::logger->error("Failed to find target '{}': {}", triple, err);
+        return false;
     }
-
+    std::unique_ptr<llvm::TargetMachine> machine(target->createTargetMachine(
+        triple, options.targetCPU, options.targetFeatures,
+        llvm::TargetOptions(), llvm::None));
+    if(!machine)
+    {
+        util::logger->error("Failed to create target machine for '{}'",
+                            triple);
+        return false;
+    }
+    module->setTargetTriple(triple);
+    module->setDataLayout(machine->createDataLayout());
     return true;
 }
 
@@ -97,16 +195,33 @@ bool Codegen::finish()
 
     using namespace fmt::literals;
 
+    // Passes run before the optimization pipeline.
+    // Instrumentation and profile use have to see the same CFG,
+    // so both are done on unoptimized IR
     const auto flags = [&]() {
         std::vector<std::string> flist;
+        const auto& options = util::ProgramOptions::view();
+        if(options.profileGenerate)
+        {
+            flist.push_back("-pgo-instr-gen");
+            flist.push_back("-instrprof");
+        }
+        if(!options.profileUse.empty())
+        {
+            flist.push_back("-pgo-instr-use");
+            flist.push_back(fmt::format("-pgo-test-profile-file={}",
+                                        options.profileUse));
+        }
 
-        return flist.empty() ? " " + util::stringutils::join(flist, ' ') : "";
+        return flist.empty() ? "" : " " + util::stringutils::join(flist, ' ');
     }();
     if(info.optEnabled())
     {
         auto opt = fmt::format("{}/varuna-opt", util::getExecDirectory());
         auto optArgs = fmt::format(
-            "{input} -o {output} -S {opt} -verify-each{stripdebug}",
+            "{input} -o {output} -S{flags} {opt}{target} "
+            "-verify-each{stripdebug}",
+            "flags"_a = flags, "target"_a = getTargetFlags(),
             "opt"_a = util::ProgramOptions::view().optLevelToString(),
             "input"_a = input.getFilename(),
             "output"_a = inputFile.getFilename(), "stripdebug"_a = [&]() {
@@ -137,8 +252,8 @@ bool Codegen::finish()
     {
         auto opt = fmt::format("{}/varuna-opt", util::getExecDirectory());
         auto optArgs = fmt::format(
-            "{input} -o {output} -S -verify{stripdebug}",
-            "input"_a = input.getFilename(),
+            "{input} -o {output} -S{flags} -verify{stripdebug}",
+            "flags"_a = flags, "input"_a = input.getFilename(),
             "output"_a = inputFile.getFilename(), "stripdebug"_a = [&]() {
                 if(util::ProgramOptions::view().stripDebug)
                 {
@@ -164,6 +279,72 @@ bool Codegen::finish()
     return true;
 }
 
+std::string Codegen::extractInlineBodies()
+{
+    // Read back the output of opt
+    llvm::SMDiagnostic err;
+    auto optimized = llvm::parseIRFile(inputFile.getFilename(), err, context);
+    if(!optimized)
+    {
+        // Not fatal, importers just can't inline anything
+        util::logger->warn("Failed to read optimized LLVM IR from {}: {}",
+                           inputFile.getFilename(), err.getMessage().str());
+        return "";
+    }
+
+    // Bodies must be small, and not refer to anything
+    // that isn't visible to importers.
+    // `@inline` functions are embedded regardless of their size,
+    // `@noinline` functions never
+    std::unordered_set<const llvm::Function*> bodies;
+    for(const auto& f : *optimized)
+    {
+        if(!import::isImportable(f) ||
+           f.hasFnAttribute(llvm::Attribute::NoInline))
+        {
+            continue;
+        }
+        if(f.hasFnAttribute(llvm::Attribute::AlwaysInline) ||
+           import::getInstructionCount(f) <= inlineBodyThreshold)
+        {
+            bodies.insert(&f);
+        }
+    }
+    if(bodies.empty())
+    {
+        return "";
+    }
+    import::keepOnlyBodies(*optimized, [&](const llvm::Function& f) {
+        return bodies.count(&f) != 0;
+    });
+
+    std::string bitcode;
+    {
+        llvm::raw_string_ostream os(bitcode);
+        llvm::WriteBitcodeToFile(optimized.get(), os);
+    }
+    util::logger->debug("Embedding {} inlinable functions in the module file",
+                        bodies.size());
+    return bitcode;
+}
+
+int32_t Codegen::execute()
+{
+    auto mainFunction = codegen->getMainFunction();
+    if(!mainFunction)
+    {
+        throw std::runtime_error(fmt::format("No main function in '{}'",
+                                             ast->file->getFilename()));
+    }
+    const auto name = mainFunction->getName().str();
+
+    JIT jit(info.optLevel, info.sizeLevel);
+    jit.addModule(std::move(module));
+
+    util::logger->debug("Running {}", name);
+    return jit.runMain(name);
+}
+
 struct OutputTypeHash
 {
     template <typename T>
@@ -284,6 +465,47 @@ void Codegen::write()
         return;
     }
 
+    if(output == util::EMIT_OBJ && util::ProgramOptions::view().lto)
+    {
+        // With -flto, the object file is bitcode with a module summary,
+        // code is generated at link time by 'varuna -lto'
+        const auto opt = fmt::format("{}/varuna-opt", execDir);
+        const auto optArgs = fmt::format(
+            "{} -o {} -module-summary", inputFile.getFilename(),
+            writeStdout ? "-" : filename(util::EMIT_OBJ));
+        util::logger->debug("Running {} {}", opt, optArgs);
+        auto p = util::Process(opt, optArgs);
+        if(!p.spawn())
+        {
+            throw std::runtime_error(fmt::format(
+                "opt ({} {}) failed: {}", opt, optArgs, p.getErrorString()));
+        }
+        if(p.getReturnValue() != 0)
+        {
+            throw std::runtime_error(
+                fmt::format("opt ({} {}) failed", opt, optArgs));
+        }
+
+        if(!writeStdout)
+        {
+            // Summary for the thin link
+            llvm::SMDiagnostic err;
+            auto m = llvm::parseIRFile(inputFile.getFilename(), err, context);
+            if(!m)
+            {
+                throw std::runtime_error(fmt::format(
+                    "Failed to read LLVM IR from {}: {}",
+                    inputFile.getFilename(), err.getMessage().str()));
+            }
+            ModuleSummary::build(*m).write(
+                ModuleSummary::getFilename(filename(util::EMIT_OBJ)));
+
+            util::logger->info("Wrote LTO bitcode in '{}'",
+                               filename(util::EMIT_OBJ));
+        }
+        return;
+    }
+
     auto outputType = [&]() {
         if(output == util::EMIT_OBJ)
         {
@@ -309,10 +531,18 @@ void Codegen::write()
             }
             return "";
         }();
+        // Instructions carry the contract flag since LLVM 5,
+        // the option is still needed for earlier versions
+        const auto fpContract =
+            util::ProgramOptions::view().fpContract == util::FP_CONTRACT_FAST
+                ? " -fp-contract=fast"
+                : "";
         return fmt::format(
-            "-filetype={} -o {} {} --x86-asm-syntax={}{} -debugger-tune=gdb",
+            "-filetype={} -o {} {} --x86-asm-syntax={}{}{}{} "
+            "-debugger-tune=gdb",
             outputType, writeStdout ? "-" : filename(output),
-            inputFile.getFilename(), x86, optStr);
+            inputFile.getFilename(), x86, optStr, getTargetFlags(),
+            fpContract);
     }();
 
     util::logger->debug("Running {} {}", llc, llcArgs);
@@ -38,6 +38,14 @@ public:
      */
     void write();
 
+    /**
+     * Compile the generated module in memory and run its main function.
+     * Used instead of write() with `-run`.
+     * \throw std::runtime_error On failure
+     * \return Return value of main
+     */
+    int32_t execute();
+
 private:
     /**
      * Initialize the code generator
@@ -54,6 +62,12 @@ private:
      * \return Success
      */
     bool finish();
+    /**
+     * Extract the bodies of small exported functions from the optimized
+     * module, so that they can be embedded in the module file
+     * \return LLVM bitcode, or an empty string if there's nothing to embed
+     */
+    std::string extractInlineBodies();
 
     /// AST
     std::shared_ptr<ast::AST> ast;
@@ -11,10 +11,24 @@
 #include "ast/Node.h"
 #include "ast/OperatorExpr.h"
 #include "ast/Stmt.h"
+#include "codegen/AttributeInference.h"
+#include "codegen/ConstEvaluator.h"
+#include "codegen/FunctionImport.h"
+#include "codegen/ModuleCache.h"
 #include "codegen/ModuleFile.h"
+#include "codegen/Reachability.h"
 #include "util/ProgramInfo.h"
 #include "util/ProgramOptions.h"
 #include "util/StringUtils.h"
+#include <llvm/IR/IntrinsicInst.h>
+#include <algorithm>
+#include <unordered_set>
+
+#if VARUNA_LLVM_VERSION == 39
+#include <llvm/Bitcode/ReaderWriter.h>
+#else
+#include <llvm/Bitcode/BitcodeReader.h>
+#endif
 
 #define USE_LLVM_MODULE_VERIFY 0
 
@@ -45,6 +59,9 @@ CodegenVisitor::CodegenVisitor(llvm::LLVMContext& c, llvm::Module* m,
 #endif
     }
 
+    // Overridden for function bodies with `@fastmath`
+    builder.setFastMathFlags(getFastMathFlags(0));
+
     // Create types
     types->insertTypeWithVariants<VoidType>(context, dbuilder);
     types->insertTypeWithVariants<Int8Type>(context, dbuilder);
@@ -59,6 +76,17 @@ CodegenVisitor::CodegenVisitor(llvm::LLVMContext& c, llvm::Module* m,
     types->insertTypeWithVariants<ByteType>(context, dbuilder);
     types->insertTypeWithVariants<StringType>(context, dbuilder);
     types->insertTypeWithVariants<CStringType>(context, dbuilder);
+
+    // SIMD vectors, 128 and 256 bits wide
+    const std::vector<std::pair<const char*, unsigned>> vectorTypes{
+        {"i8", 16},  {"i8", 32}, {"i16", 8}, {"i16", 16},
+        {"i32", 4},  {"i32", 8}, {"i64", 2}, {"i64", 4},
+        {"f32", 4},  {"f32", 8}, {"f64", 2}, {"f64", 4}};
+    for(const auto& v : vectorTypes)
+    {
+        types->insertType(std::make_unique<VectorType>(
+            types.get(), context, dbuilder, types->find(v.first), v.second));
+    }
 }
 
 bool CodegenVisitor::codegen(ast::AST* ast)
@@ -84,8 +112,21 @@ bool CodegenVisitor::codegen(ast::AST* ast)
         }
     }
 
-    auto exports = symbols->findExports();
-    writeExports(std::move(exports));
+    // Internal definitions that nothing refers to are checked like
+    // everything else, but left out of the module
+    removeUnreachable(reachability::findUnreachable(root));
+
+    // Profile names of internal functions are prefixed with the source
+    // filename, which depends on where the module is compiled from.
+    // Use the module name instead, so that profiles stay valid across builds
+    if(util::ProgramOptions::view().profileGenerate ||
+       !util::ProgramOptions::view().profileUse.empty())
+    {
+        module->setSourceFileName(module->getModuleIdentifier());
+    }
+
+    // The module file is written after optimization, see Codegen::run()
+    exports = symbols->findExports();
 
     // Only dump global symbols because all other symbols have been popped
     symbols->dump();
@@ -94,8 +135,26 @@ bool CodegenVisitor::codegen(ast::AST* ast)
 
     stripInstructionsAfterTerminators();
 
+    // Attributes are only useful to the optimizer.
+    // Imported bodies are linked after this,
+    // their attributes were already inferred in their own module
+    if(info.optEnabled())
+    {
+        inference::inferAttributes(*module);
+    }
+
     dbuilder.finalize();
 
+    // Bodies are only useful to the optimizer
+    if(info.optEnabled() && !linkImportedBodies())
+    {
+        return false;
+    }
+
+    // Imported bodies get the attributes of this module too,
+    // the inliner refuses to inline functions with different target features
+    setTargetAttributes();
+
 #if USE_LLVM_MODULE_VERIFY
     // Buggy, don't use
     util::logger->trace("Verifying module");
@@ -112,6 +171,161 @@ bool CodegenVisitor::codegen(ast::AST* ast)
     return true;
 }
 
+void CodegenVisitor::removeUnreachable(
+    const std::unordered_set<const ast::Node*>& unreachable)
+{
+    auto& globals = symbols->getList().front();
+    std::vector<llvm::GlobalValue*> removed;
+    for(const auto node : unreachable)
+    {
+        const auto name = reachability::getRemovableName(node);
+        auto it = globals.find(name);
+        if(it == globals.end())
+        {
+            continue;
+        }
+        auto g = llvm::dyn_cast_or_null<llvm::GlobalValue>(
+            it->second->value->value);
+        if(g && g->getParent() == module)
+        {
+            util::logger->debug("'{}' is never used, removing it", name);
+            removed.push_back(g);
+        }
+        globals.erase(it);
+    }
+
+    // Unreachable definitions may still refer to each other
+    for(auto g : removed)
+    {
+        if(auto f = llvm::dyn_cast<llvm::Function>(g))
+        {
+            f->deleteBody();
+        }
+        else if(auto var = llvm::dyn_cast<llvm::GlobalVariable>(g))
+        {
+            var->setInitializer(nullptr);
+        }
+    }
+    for(auto g : removed)
+    {
+        g->removeDeadConstantUsers();
+        if(!g->use_empty())
+        {
+            g->replaceAllUsesWith(llvm::UndefValue::get(g->getType()));
+        }
+        g->eraseFromParent();
+    }
+}
+
+void CodegenVisitor::rollbackIncremental()
+{
+    // Nothing from a failed input ends up in the session.
+    // Scopes aren't popped on error, so there may be some left
+    while(symbols->getList().size() > 1)
+    {
+        symbols->removeTopBlock();
+    }
+    auto& globals = symbols->getList().front();
+    for(auto it = globals.begin(); it != globals.end();)
+    {
+        if(previousSymbols.count(it->first) == 0)
+        {
+            it = globals.erase(it);
+        }
+        else
+        {
+            // May point into the discarded module
+            it->second->value->value = nullptr;
+            it->second->isLazy = true;
+            ++it;
+        }
+    }
+}
+
+bool CodegenVisitor::codegenIncremental(ast::AST* ast, llvm::Module* m,
+                                        ast::Expr* expr)
+{
+    assert(m);
+    assert(!info.emitDebug);
+    module = m;
+    types->setModule(m);
+    mainFunction = nullptr;
+    resultType = nullptr;
+
+    // The global scope is never popped
+    if(symbols->getList().empty())
+    {
+        symbols->addBlock();
+    }
+
+    // Values of the earlier inputs live in their own modules,
+    // declare them again in this one on first use
+    previousSymbols.clear();
+    for(auto& s : symbols->getList().front())
+    {
+        s.second->value->value = nullptr;
+        s.second->isLazy = true;
+        previousSymbols.insert(s.first);
+    }
+
+    for(auto& child : ast->globalNode->nodes)
+    {
+        if(!child->accept(this))
+        {
+            rollbackIncremental();
+            return false;
+        }
+    }
+    if(expr && !codegenResult(expr))
+    {
+        rollbackIncremental();
+        return false;
+    }
+
+    stripInstructionsAfterTerminators();
+    setTargetAttributes();
+
+    // Later inputs refer to the definitions from their own modules
+    for(auto& s : symbols->getList().front())
+    {
+        auto g = llvm::dyn_cast_or_null<llvm::GlobalValue>(
+            s.second->value->value);
+        if(g && g->getParent() == module && g->hasLocalLinkage())
+        {
+            g->setLinkage(llvm::GlobalValue::ExternalLinkage);
+        }
+    }
+    return true;
+}
+
+bool CodegenVisitor::codegenResult(ast::Expr* expr)
+{
+    const auto name = module->getModuleIdentifier();
+    auto func = llvm::Function::Create(
+        llvm::FunctionType::get(llvm::Type::getVoidTy(context), false),
+        llvm::Function::ExternalLinkage, name + ".expr", module);
+    builder.SetInsertPoint(llvm::BasicBlock::Create(context, "entry", func));
+
+    symbols->addBlock();
+    auto val = expr->accept(this);
+    symbols->removeTopBlock();
+    if(!val)
+    {
+        return false;
+    }
+
+    if(val->type->isSized() && val->cat != TypedValue::STMTVALUE)
+    {
+        auto result = new llvm::GlobalVariable(
+            *module, val->type->type, false, llvm::GlobalValue::ExternalLinkage,
+            llvm::Constant::getNullValue(val->type->type), name + ".result");
+        builder.CreateStore(val->value, result);
+        resultType = val->type;
+    }
+    builder.CreateRetVoid();
+    return true;
+}
+
 void CodegenVisitor::emitDebugLocation(ast::Node* node)
 {
     if(info.emitDebug)
@@ -129,22 +343,38 @@ void CodegenVisitor::emitDebugLocation(ast::Node* node)
     }
 }
 
-void CodegenVisitor::writeExports(std::unique_ptr<SymbolTable> exports)
+void CodegenVisitor::writeModuleFile(const std::string& bitcode)
 {
-    if(util::ProgramOptions::view().outputFilename == "-" ||
-       !util::ProgramOptions::view().generateModuleFile)
-    {
-        util::logger->info("Not writing module export file");
-        return;
-    }
-
+    assert(exports);
     auto filename = getModuleFilename(module->getName());
     ModuleFile mod(filename);
     mod.write(ModuleFile::ModuleFileSymbolTable::createFromSymbolTable(
-        std::move(exports)));
+                  std::move(exports)),
+              bitcode);
+    ModuleCache::get().invalidate(filename);
     util::logger->info("Wrote module export file in '{}'", filename);
 }
 
+void CodegenVisitor::setTargetAttributes()
+{
+    const auto& options = util::ProgramOptions::view();
+    for(auto& f : *module)
+    {
+        if(f.isDeclaration())
+        {
+            continue;
+        }
+        if(!options.targetCPU.empty())
+        {
+            f.addFnAttr("target-cpu", options.targetCPU);
+        }
+        if(!options.targetFeatures.empty())
+        {
+            f.addFnAttr("target-features", options.targetFeatures);
+        }
+    }
+}
+
 void CodegenVisitor::stripInstructionsAfterTerminators()
 {
     // Iterate every function
@@ -174,7 +404,14 @@ void CodegenVisitor::stripInstructionsAfterTerminators()
                 // Terminator has been found in this block
                 if(termFound)
                 {
-                    // Remove the instruction
+                    // Remove the instruction.
+                    // Immutable variables are bound to instructions,
+                    // so it may be used in other (unreachable) blocks
+                    if(!inst->use_empty())
+                    {
+                        inst->replaceAllUsesWith(
+                            llvm::UndefValue::get(inst->getType()));
+                    }
                     inst = inst->eraseFromParent();
                 }
                 else
@@ -209,6 +446,15 @@ FunctionSymbol* CodegenVisitor::findFunction(const std::string& name,
 {
     // Find a symbol with a similar name
     auto f = symbols->find(name, Type::FUNCTION);
+    if(!f && !symbols->find(name))
+    {
+        // Not defined in this module, look from imports
+        f = findImportedSymbol(name);
+        if(f && !f->isFunction())
+        {
+            f = nullptr;
+        }
+    }
     if(f)
     {
         // Found one!
@@ -217,6 +463,7 @@ FunctionSymbol* CodegenVisitor::findFunction(const std::string& name,
         // be a FunctionSymbol.
         // Therefore, a static_cast is safe
         auto func = dynamic_cast<FunctionSymbol*>(f);
+        materializeSymbol(func);
         assert(func->value->value);
         return func;
     }
@@ -251,12 +498,20 @@ CodegenVisitor::declareFunction(FunctionType* type, const std::string& name,
                             func->value->type->getName(), type->getName());
     }
 
+    uint32_t attributes = 0;
+    if(!getFunctionAttributes(proto, attributes))
+    {
+        return nullptr;
+    }
+
     // Codegen prototype
     auto accept = proto->accept(this);
     if(!accept)
     {
         return nullptr;
     }
+    applyFunctionAttributes(llvm::cast<llvm::Function>(accept->value),
+                            attributes);
 
     // Mangle function name
     if(proto->mangle)
@@ -271,6 +526,7 @@ CodegenVisitor::declareFunction(FunctionType* type, const std::string& name,
                                                 name, proto);
     var->isExport = proto->isExport;
     var->mangled = proto->mangle;
+    var->attributes = attributes;
     auto varptr = var.get();
     symbols->getTop().insert(std::make_pair(name, std::move(var)));
     return varptr;
@@ -286,6 +542,11 @@ CodegenVisitor::createEntryBlockAlloca(llvm::Function* func, llvm::Type* type,
     return tmp.CreateAlloca(type, nullptr, name);
 }
 
+bool CodegenVisitor::needsStorage(Type* type) const
+{
+    return info.emitDebug || type->type->isArrayTy();
+}
+
 ast::FunctionPrototypeStmt*
 CodegenVisitor::getNodeFunction(ast::Node* node) const
 {
@@ -301,12 +562,10 @@ CodegenVisitor::getNodeFunction(ast::Node* node) const
 bool CodegenVisitor::importModule(ast::ImportStmt* import)
 {
     auto moduleName = getModuleFilename(import->importee->value);
-    ModuleFile mod(moduleName);
-    auto tree = [&]() -> decltype(mod.read().toAST()) {
+    auto view = [&]() -> ModuleCache::ViewPtr {
         try
         {
-            auto t = mod.read();
-            return t.toAST();
+            return ModuleCache::get().open(moduleName);
         }
         catch(const std::exception& e)
         {
@@ -316,20 +575,272 @@ bool CodegenVisitor::importModule(ast::ImportStmt* import)
             return nullptr;
         }
     }();
-    if(!tree)
+    if(!view)
     {
         return false;
     }
-    for(auto& node : tree->globalNode->nodes)
+
+    // Symbols are looked up from the module file index when needed,
+    // see findImportedSymbol()
+    const auto alreadyImported =
+        std::any_of(imports.begin(), imports.end(),
+                    [&](const auto& i) { return i.first == view; });
+    if(!alreadyImported)
+    {
+        imports.emplace_back(std::move(view), import);
+    }
+    return true;
+}
+
+Symbol* CodegenVisitor::findImportedSymbol(const std::string& name)
+{
+    for(const auto& i : imports)
+    {
+        auto entry = i.first->find(name);
+        if(!entry)
+        {
+            continue;
+        }
+        if(entry.isFunction())
+        {
+            return declareImportedFunction(entry, i.second);
+        }
+        return declareImportedVariable(entry, i.second);
+    }
+    return nullptr;
+}
+
+bool CodegenVisitor::isImportedSymbol(const std::string& name) const
+{
+    return std::any_of(imports.begin(), imports.end(), [&](const auto& i) {
+        return static_cast<bool>(i.first->find(name));
+    });
+}
+
+FunctionSymbol*
+CodegenVisitor::declareImportedFunction(const ModuleFileView::Entry& s,
+                                        ast::ImportStmt* import)
+{
+    auto returnType = findType(s.getReturnTypeName().str());
+    if(!returnType)
+    {
+        return codegenError(import, "Invalid import: Undefined typename: '{}'",
+                            s.getReturnTypeName().str());
+    }
+    std::vector<Type*> paramTypes;
+    paramTypes.reserve(s.getParamCount());
+    for(size_t i = 0; i < s.getParamCount(); ++i)
     {
-        if(!node->accept(this))
+        auto t = findType(s.getParamTypeName(i).str());
+        if(!t)
         {
+            return codegenError(import,
+                                "Invalid import: Undefined typename: '{}'",
+                                s.getParamTypeName(i).str());
+        }
+        paramTypes.push_back(t);
+    }
+    auto type = findFunctionType(returnType, paramTypes);
+
+    // Don't declare it in the LLVM module yet,
+    // materializeSymbol() does that on first use
+    auto name = s.getName().str();
+    auto val = std::make_unique<TypedValue>(type, nullptr,
+                                            TypedValue::STMTVALUE, false);
+    auto var = std::make_unique<FunctionSymbol>(s.getLocation(),
+                                                std::move(val), name, nullptr);
+    var->mangled = s.isMangled();
+    var->attributes = s.getAttributes();
+    var->isLazy = true;
+    auto varptr = var.get();
+    // Imported symbols always go to the global scope
+    symbols->getList().front().insert(std::make_pair(name, std::move(var)));
+    return varptr;
+}
+
+Symbol* CodegenVisitor::declareImportedVariable(const ModuleFileView::Entry& s,
+                                                ast::ImportStmt* import)
+{
+    auto type = findType(s.getTypeName().str());
+    if(!type)
+    {
+        return codegenError(import, "Invalid import: Undefined typename: '{}'",
+                            s.getTypeName().str());
+    }
+
+    // Declared on first use by materializeSymbol()
+    auto name = s.getName().str();
+    auto val = std::make_unique<TypedValue>(type, nullptr, TypedValue::LVALUE,
+                                            s.isMutable());
+    auto var = std::make_unique<Symbol>(s.getLocation(), std::move(val), name,
+                                        s.isMutable());
+    var->isLazy = true;
+    auto varptr = var.get();
+    // Imported symbols always go to the global scope
+    symbols->getList().front().insert(std::make_pair(name, std::move(var)));
+    return varptr;
+}
+
+Symbol* CodegenVisitor::findSymbol(const std::string& name)
+{
+    auto s = symbols->find(name);
+    if(!s)
+    {
+        s = findImportedSymbol(name);
+    }
+    if(s)
+    {
+        materializeSymbol(s);
+    }
+    return s;
+}
+
+void CodegenVisitor::materializeSymbol(Symbol* s)
+{
+    assert(s);
+    if(!s->isLazy)
+    {
+        return;
+    }
+
+    // External declarations, the definitions live in the importee
+    if(s->isFunction())
+    {
+        auto func = static_cast<FunctionSymbol*>(s);
+        auto type = static_cast<FunctionType*>(func->getType());
+        auto name =
+            func->mangled ? mangleFunctionName(func->name, type) : func->name;
+        auto f = llvm::Function::Create(
+            llvm::cast<llvm::FunctionType>(type->type),
+            llvm::Function::ExternalLinkage, name, module);
+        applyFunctionAttributes(f, func->attributes);
+        // Defined in Varuna, see inference::inferAttributes()
+        if(info.optEnabled())
+        {
+            f->addFnAttr(llvm::Attribute::NoUnwind);
+        }
+        func->value->value = f;
+    }
+    else
+    {
+        s->value->value = new llvm::GlobalVariable(
+            *module, s->getType()->type, !s->isMutable,
+            llvm::GlobalValue::ExternalLinkage, nullptr, s->name);
+    }
+    s->isLazy = false;
+}
+
+bool CodegenVisitor::linkImportedBodies()
+{
+    for(const auto& i : imports)
+    {
+        const auto bitcode = i.first->getBitcode();
+        if(bitcode.empty())
+        {
+            continue;
+        }
+
+        const auto& name = i.second->importee->value;
+        auto bodies = llvm::parseBitcodeFile(
+            llvm::MemoryBufferRef(bitcode, name), context);
+        if(!bodies)
+        {
+#if VARUNA_LLVM_VERSION == 39
+            const auto error = bodies.getError().message();
+#else
+            const auto error = llvm::toString(bodies.takeError());
+#endif
+            // Not fatal, the functions just won't be inlined
+            codegenWarning(i.second,
+                           "Failed to read inlinable functions of '{}': {}",
+                           name, error);
+            continue;
+        }
+
+        if(!import::linkBodies(*module, std::move(*bodies)))
+        {
+            codegenError(i.second, "Failed to link inlinable functions of '{}'",
+                         name);
             return false;
         }
     }
     return true;
 }
 
+FunctionType* CodegenVisitor::findFunctionType(Type* returnType,
+                                               const std::vector<Type*>& params)
+{
+    auto t =
+        types->find(FunctionType::functionTypeToString(returnType, params));
+    if(!t)
+    {
+        // If none was found, create it
+        auto ft = std::make_unique<FunctionType>(types.get(), context, dbuilder,
+                                                 returnType, params);
+        t = ft.get();
+        types->insertType(std::move(ft));
+    }
+    return dynamic_cast<FunctionType*>(t);
+}
+
+Type* CodegenVisitor::findType(const std::string& name)
+{
+    auto t = types->find(name);
+    if(t || name.size() < 3 || name.front() != '[' || name.back() != ']')
+    {
+        return t;
+    }
+
+    // "[T; N]" or "[T]", where T can be an array or a slice too
+    const auto inner = name.substr(1, name.size() - 2);
+    auto separator = std::string::npos;
+    int depth = 0;
+    for(size_t i = 0; i < inner.size(); ++i)
+    {
+        if(inner[i] == '[')
+        {
+            ++depth;
+        }
+        else if(inner[i] == ']')
+        {
+            --depth;
+        }
+        else if(inner[i] == ';' && depth == 0)
+        {
+            separator = i;
+        }
+    }
+
+    auto element = findType(inner.substr(0, separator));
+    if(!element || !element->isSized() || element->kind == Type::FUNCTION)
+    {
+        return nullptr;
+    }
+    if(separator == std::string::npos)
+    {
+        return types->insertType(std::make_unique<SliceType>(
+            types.get(), context, dbuilder, element));
+    }
+
+    uint64_t length = 0;
+    try
+    {
+        length = std::stoull(inner.substr(separator + 1));
+    }
+    catch(const std::exception&)
+    {
+        return nullptr;
+    }
+    auto array = std::make_unique<ArrayType>(types.get(), context, dbuilder,
+                                             element, length);
+    if(array->getName() != name)
+    {
+        // Not in canonical form, e.g. "[i32;4]"
+        return nullptr;
+    }
+    return types->insertType(std::move(array));
+}
+
 std::pair<Type*, std::unique_ptr<TypedValue>>
 CodegenVisitor::inferVariableDefType(ast::VariableDefinitionExpr* node)
 {
@@ -359,7 +870,13 @@ CodegenVisitor::inferVariableDefType(ast::VariableDefinitionExpr* node)
     }
     else
     {
-        type = types->find(node->type->value);
+        type = findType(node->type->value);
+        if(!type)
+        {
+            return err(codegenError(node->type.get(),
+                                    "Undefined typename: '{}'",
+                                    node->type->value));
+        }
     }
     assert(type);
 
@@ -395,7 +912,8 @@ CodegenVisitor::inferVariableDefType(ast::VariableDefinitionExpr* node)
     }
 
     // Check for existing similarly named symbol
-    if(symbols->find(node->name->value, nullptr, false))
+    if(symbols->find(node->name->value, nullptr, false) ||
+       isImportedSymbol(node->name->value))
     {
         return err(
             codegenError(node->name.get(),
@@ -406,6 +924,456 @@ CodegenVisitor::inferVariableDefType(ast::VariableDefinitionExpr* node)
     return ret(type, std::move(init));
 }
 
+std::pair<Type*, std::unique_ptr<TypedValue>>
+CodegenVisitor::evaluateConstVariableDef(ast::VariableDefinitionExpr* node)
+{
+    auto func = llvm::Function::Create(
+        llvm::FunctionType::get(builder.getVoidTy(), false),
+        llvm::Function::InternalLinkage, node->name->value + ".const", module);
+    builder.SetInsertPoint(llvm::BasicBlock::Create(context, "entry", func));
+
+    constContext = true;
+    auto def = inferVariableDefType(node);
+    constContext = false;
+
+    // Already constant if the initializer didn't call anything
+    if(def.second && !llvm::isa<llvm::Constant>(def.second->value))
+    {
+        builder.CreateRetVoid();
+        try
+        {
+            ConstEvaluator evaluator;
+            def.second->value = evaluator.evaluate(func, def.second->value);
+        }
+        catch(const std::runtime_error& e)
+        {
+            codegenError(node->init.get(),
+                         "Compile-time evaluation of '{}' failed: {}",
+                         node->name->value, e.what());
+            def.first = nullptr;
+            def.second = nullptr;
+        }
+    }
+
+    builder.ClearInsertionPoint();
+    func->eraseFromParent();
+    return def;
+}
+
+bool CodegenVisitor::createLoopMetadata(
+    const std::vector<ast::Attribute>& attributes, llvm::MDNode*& loopID)
+{
+    loopID = nullptr;
+    if(attributes.empty())
+    {
+        return true;
+    }
+
+    // The first operand is a reference to the node itself
+    auto tmp = llvm::MDNode::getTemporary(context, llvm::None);
+    std::vector<llvm::Metadata*> ops{tmp.get()};
+    auto hint = [&](const char* name, llvm::Metadata* value) {
+        ops.push_back(llvm::MDNode::get(
+            context, {llvm::MDString::get(context, name), value}));
+    };
+    auto i32 = [&](int64_t value) {
+        return llvm::ConstantAsMetadata::get(
+            builder.getInt32(static_cast<uint32_t>(value)));
+    };
+
+    std::unordered_set<std::string> given;
+    for(const auto& a : attributes)
+    {
+        if(!given.insert(a.name).second)
+        {
+            util::logCompilerError(a.loc, "Duplicate loop attribute '@{}'",
+                                   a.name);
+            return false;
+        }
+
+        const bool takesCount = a.name == "vectorize" ||
+                                a.name == "unroll" || a.name == "interleave";
+        if(!takesCount && a.name != "nounroll")
+        {
+            util::logCompilerError(a.loc, "Unknown loop attribute '@{}'",
+                                   a.name);
+            return false;
+        }
+        if(a.args.size() > (takesCount ? 1u : 0u))
+        {
+            util::logCompilerError(a.loc,
+                                   "Too many arguments given to '@{}'", a.name);
+            return false;
+        }
+        if(!a.args.empty() && (a.args[0] < 1 || a.args[0] > 65536))
+        {
+            util::logCompilerError(
+                a.loc, "Invalid argument to '@{}': {} is not in [1, 65536]",
+                a.name, a.args[0]);
+            return false;
+        }
+
+        if(a.name == "vectorize")
+        {
+            // @vectorize(1) disables vectorization
+            if(a.args.empty() || a.args[0] > 1)
+            {
+                hint("llvm.loop.vectorize.enable",
+                     llvm::ConstantAsMetadata::get(builder.getTrue()));
+            }
+            if(!a.args.empty())
+            {
+                hint("llvm.loop.vectorize.width", i32(a.args[0]));
+            }
+        }
+        else if(a.name == "interleave")
+        {
+            if(a.args.empty())
+            {
+                util::logCompilerError(
+                    a.loc, "'@interleave' requires the interleave count");
+                return false;
+            }
+            hint("llvm.loop.interleave.count", i32(a.args[0]));
+        }
+        else if(a.name == "unroll")
+        {
+            if(a.args.empty())
+            {
+                ops.push_back(llvm::MDNode::get(
+                    context,
+                    {llvm::MDString::get(context, "llvm.loop.unroll.enable")}));
+            }
+            else
+            {
+                hint("llvm.loop.unroll.count", i32(a.args[0]));
+            }
+        }
+        else
+        {
+            ops.push_back(llvm::MDNode::get(
+                context,
+                {llvm::MDString::get(context, "llvm.loop.unroll.disable")}));
+        }
+    }
+    if(given.count("unroll") != 0 && given.count("nounroll") != 0)
+    {
+        util::logCompilerError(attributes.front().loc,
+                               "'@unroll' and '@nounroll' are exclusive");
+        return false;
+    }
+
+    loopID = llvm::MDNode::getDistinct(context, ops);
+    loopID->replaceOperandWith(0, loopID);
+    return true;
+}
+
+bool CodegenVisitor::getFunctionAttributes(ast::FunctionPrototypeStmt* proto,
+                                           uint32_t& attributes)
+{
+    attributes = 0;
+    const auto& names = FunctionSymbol::getAttributeNames();
+    for(const auto& a : proto->attributes)
+    {
+        auto it = std::find(names.begin(), names.end(), a.name);
+        if(it == names.end())
+        {
+            util::logCompilerError(a.loc, "Unknown function attribute '@{}'",
+                                   a.name);
+            return false;
+        }
+        const auto bit = 1u << static_cast<uint32_t>(it - names.begin());
+        if((attributes & bit) != 0)
+        {
+            util::logCompilerError(a.loc, "Duplicate function attribute '@{}'",
+                                   a.name);
+            return false;
+        }
+        if(!a.args.empty())
+        {
+            util::logCompilerError(a.loc, "'@{}' takes no arguments", a.name);
+            return false;
+        }
+        attributes |= bit;
+    }
+
+    const auto exclusive = [&](uint32_t a, uint32_t b, const char* aname,
+                               const char* bname) {
+        if((attributes & a) != 0 && (attributes & b) != 0)
+        {
+            codegenError(proto, "'@{}' and '@{}' are exclusive", aname, bname);
+            return true;
+        }
+        return false;
+    };
+    return !exclusive(FunctionSymbol::ATTR_INLINE,
+                      FunctionSymbol::ATTR_NOINLINE, "inline", "noinline") &&
+           !exclusive(FunctionSymbol::ATTR_HOT, FunctionSymbol::ATTR_COLD,
+                      "hot", "cold") &&
+           !exclusive(FunctionSymbol::ATTR_PURE, FunctionSymbol::ATTR_CONST,
+                      "pure", "const");
+}
+
+void CodegenVisitor::applyFunctionAttributes(llvm::Function* f,
+                                             uint32_t attributes)
+{
+    if((attributes & FunctionSymbol::ATTR_INLINE) != 0)
+    {
+        f->addFnAttr(llvm::Attribute::AlwaysInline);
+    }
+    if((attributes & FunctionSymbol::ATTR_NOINLINE) != 0)
+    {
+        f->addFnAttr(llvm::Attribute::NoInline);
+    }
+    // There's no `hot` attribute in LLVM,
+    // so hot functions are only placed in a separate section
+    if((attributes & FunctionSymbol::ATTR_HOT) != 0)
+    {
+        f->addFnAttr(llvm::Attribute::InlineHint);
+#if VARUNA_LLVM_VERSION >= 40
+        f->setSectionPrefix(".hot");
+#endif
+    }
+    if((attributes & FunctionSymbol::ATTR_COLD) != 0)
+    {
+        f->addFnAttr(llvm::Attribute::Cold);
+        f->addFnAttr(llvm::Attribute::OptimizeForSize);
+#if VARUNA_LLVM_VERSION >= 40
+        f->setSectionPrefix(".unlikely");
+#endif
+    }
+    if((attributes & FunctionSymbol::ATTR_PURE) != 0)
+    {
+        f->addFnAttr(llvm::Attribute::ReadOnly);
+        f->addFnAttr(llvm::Attribute::NoUnwind);
+    }
+    if((attributes & FunctionSymbol::ATTR_CONST) != 0)
+    {
+        f->addFnAttr(llvm::Attribute::ReadNone);
+        f->addFnAttr(llvm::Attribute::NoUnwind);
+    }
+
+    // The flags of the instructions are set in visit(FunctionDefinitionStmt),
+    // these tell the backend what it may do with the whole function
+    const auto fmf = getFastMathFlags(attributes);
+    if(fmf.unsafeAlgebra())
+    {
+        f->addFnAttr("unsafe-fp-math", "true");
+        f->addFnAttr("no-nans-fp-math", "true");
+        f->addFnAttr("no-infs-fp-math", "true");
+    }
+    if(fmf.noSignedZeros())
+    {
+        f->addFnAttr("no-signed-zeros-fp-math", "true");
+    }
+}
+
+llvm::FastMathFlags CodegenVisitor::getFastMathFlags(uint32_t attributes) const
+{
+    const auto& options = util::ProgramOptions::view();
+    llvm::FastMathFlags flags;
+    if(options.fastMath || (attributes & FunctionSymbol::ATTR_FASTMATH) != 0)
+    {
+        // Reassociation, needed for vectorizing reductions,
+        // is only allowed by all of them together
+        flags.setUnsafeAlgebra();
+    }
+    if(options.noSignedZeros)
+    {
+        flags.setNoSignedZeros();
+    }
+    if(options.reciprocalMath)
+    {
+        flags.setAllowReciprocal();
+    }
+#if VARUNA_LLVM_VERSION >= 50
+    // Before LLVM 5, contraction is only controlled by llc -fp-contract
+    if(flags.unsafeAlgebra() || options.fpContract == util::FP_CONTRACT_FAST)
+    {
+        flags.setAllowContract(true);
+    }
+#endif
+    return flags;
+}
+
+bool CodegenVisitor::checkFunctionBody(ast::FunctionDefinitionStmt* node,
+                                       llvm::Function* f, uint32_t attributes)
+{
+    const bool isConst = (attributes & FunctionSymbol::ATTR_CONST) != 0;
+    const bool isPure = (attributes & FunctionSymbol::ATTR_PURE) != 0;
+    if(!isConst && !isPure)
+    {
+        return true;
+    }
+    const auto attr = isConst ? "const" : "pure";
+    const auto forbidden = isConst
+                               ? inference::ACCESS_READ | inference::ACCESS_WRITE
+                               : inference::ACCESS_WRITE;
+
+    for(auto& bb : *f)
+    {
+        for(auto& inst : bb)
+        {
+            const auto access = inference::getMemoryAccess(inst);
+            if((access & forbidden) == 0)
+            {
+                continue;
+            }
+
+            auto call = llvm::dyn_cast<llvm::CallInst>(&inst);
+            if(!call)
+            {
+                codegenError(node->proto.get(), "'@{}' function '{}' {} memory",
+                             attr, node->proto->name->value,
+                             (access & inference::ACCESS_WRITE) != 0
+                                 ? "writes to"
+                                 : "reads from");
+                return false;
+            }
+            // Traps for failed bounds checks are allowed
+            if(call->doesNotReturn())
+            {
+                continue;
+            }
+            auto callee = call->getCalledFunction();
+            codegenError(node->proto.get(),
+                         "'@{}' function '{}' calls '{}', which isn't '@{}'",
+                         attr, node->proto->name->value,
+                         callee ? callee->getName().str() : "<indirect>",
+                         attr);
+            return false;
+        }
+    }
+    return true;
+}
+
+namespace
+{
+/**
+ * Check if the address of a local variable of a function may be used
+ * outside of it, e.g. when a local array is passed as a slice
+ * \param  f Function
+ * \return   true if an address may escape
+ */
+bool localsEscape(const llvm::Function& f)
+{
+    std::vector<const llvm::Value*> addresses;
+    for(const auto& bb : f)
+    {
+        for(const auto& inst : bb)
+        {
+            if(llvm::isa<llvm::AllocaInst>(&inst))
+            {
+                addresses.push_back(&inst);
+            }
+        }
+    }
+
+    // Follow the addresses derived from the allocas
+    while(!addresses.empty())
+    {
+        auto address = addresses.back();
+        addresses.pop_back();
+        for(auto user : address->users())
+        {
+            if(llvm::isa<llvm::LoadInst>(user) ||
+               llvm::isa<llvm::MemIntrinsic>(user) ||
+               llvm::isa<llvm::DbgInfoIntrinsic>(user))
+            {
+                continue;
+            }
+            if(auto store = llvm::dyn_cast<llvm::StoreInst>(user))
+            {
+                if(store->getValueOperand() == address)
+                {
+                    return true;
+                }
+                continue;
+            }
+            if(llvm::isa<llvm::GetElementPtrInst>(user) ||
+               llvm::isa<llvm::BitCastInst>(user))
+            {
+                addresses.push_back(user);
+                continue;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+} // namespace
+
+bool CodegenVisitor::finishTailCalls(llvm::Function* f)
+{
+    // The callee of a tail call may not access the allocas of the caller
+    if(localsEscape(*f))
+    {
+        if(!mustTailCalls.empty())
+        {
+            auto node = mustTailCalls.front().second;
+            codegenError(node->returnValue.get(),
+                         "Invalid become: Local variables of '{}' may be "
+                         "accessed through the arguments",
+                         node->getFunction()->proto->name->value);
+            mustTailCalls.clear();
+            return false;
+        }
+        return true;
+    }
+    mustTailCalls.clear();
+
+    // A call directly followed by returning its result is in tail position.
+    // The optimizer would find these too, but only when it runs
+    for(auto& bb : *f)
+    {
+        for(auto& inst : bb)
+        {
+            auto ret = llvm::dyn_cast<llvm::ReturnInst>(&inst);
+            if(!ret || !ret->getPrevNode())
+            {
+                continue;
+            }
+            auto call = llvm::dyn_cast<llvm::CallInst>(ret->getPrevNode());
+            if(!call || call->isMustTailCall())
+            {
+                continue;
+            }
+            if(ret->getReturnValue() == call ||
+               (!ret->getReturnValue() && call->getType()->isVoidTy()))
+            {
+                call->setTailCall();
+            }
+        }
+    }
+    return true;
+}
+
+bool CodegenVisitor::checkConstUse(ast::Node* node, Symbol* s) const
+{
+    if(s->isFunction())
+    {
+        auto proto = static_cast<FunctionSymbol*>(s)->proto;
+        if(!proto || !proto->isConst)
+        {
+            codegenError(node,
+                         "Cannot call non-const function '{}' in a constant "
+                         "expression",
+                         s->name);
+            return false;
+        }
+        return true;
+    }
+    if(s->isMutable && llvm::isa<llvm::GlobalVariable>(s->value->value))
+    {
+        codegenError(node,
+                     "Cannot use mutable global variable '{}' in a constant "
+                     "expression",
+                     s->name);
+        return false;
+    }
+    return true;
+}
+
 std::string CodegenVisitor::getModuleFilename() const
 {
     return getModuleFilename(info.file->getFilename());
@@ -10,6 +10,7 @@
 #include "ast/Node.h"
 #include "ast/Visitor.h"
 #include "codegen/CodegenInfo.h"
+#include "codegen/ModuleFile.h"
 #include "codegen/Symbol.h"
 #include "codegen/SymbolTable.h"
 #include "codegen/Type.h"
@@ -23,6 +24,7 @@
 #include <llvm/IR/Value.h>
 #include <llvm/IR/Verifier.h>
 #include <llvm/Support/raw_os_ostream.h>
+#include <unordered_set>
 
 namespace codegen
 {
@@ -40,6 +42,52 @@ public:
      */
     bool codegen(ast::AST* ast);
 
+    /**
+     * Generate code for one input of an interactive session.
+     * Every input is generated into a new module.
+     * Global symbols are kept between inputs,
+     * and declared in the new module on first use.
+     * Debug info is not supported.
+     *
+     * An expression is generated into the function `<module>.expr`,
+     * which stores its value in the global variable `<module>.result`,
+     * see getResultType().
+     * \param  ast  AST of the input
+     * \param  m    Module to generate code into
+     * \param  expr Expression to evaluate, or nullptr
+     * \return      Success
+     */
+    bool codegenIncremental(ast::AST* ast, llvm::Module* m,
+                            ast::Expr* expr = nullptr);
+
+    /**
+     * Undo the last codegenIncremental(): remove the symbols it added.
+     * Called on failure, and when its module can't be used
+     */
+    void rollbackIncremental();
+
+    /// Get the type of the value of the last expression given to
+    /// codegenIncremental(), nullptr if it had no value
+    Type* getResultType() const
+    {
+        return resultType;
+    }
+
+    /**
+     * Write the exported symbols of the module into its module file.
+     * Called after optimization.
+     * \throw std::runtime_error On failure
+     * \param bitcode LLVM bitcode of inlinable exported functions, may be
+     * empty
+     */
+    void writeModuleFile(const std::string& bitcode);
+
+    /// Get the main function of the module, nullptr if there's none
+    llvm::Function* getMainFunction() const
+    {
+        return mainFunction;
+    }
+
     /// Dump the module to stdout
     void dumpModule() const
     {
@@ -66,8 +114,6 @@ private:
     std::string getModuleFilename() const;
     std::string getModuleFilename(const std::string& moduleName) const;
 
-    void writeExports(std::unique_ptr<SymbolTable> exports);
-
     /// Create a new void-typed value
     std::unique_ptr<TypedValue> createVoidVal(llvm::Value* v = nullptr);
     /// Get a dummy LLVM value
@@ -75,7 +121,39 @@ private:
     /// Get a typed dummy value
     std::unique_ptr<TypedValue> getTypedDummyValue();
 
+    /**
+     * Import the exported symbols of a module.
+     * Module files are opened through ModuleCache.
+     * Symbols are declared lazily, see findImportedSymbol().
+     * \param  import Import statement
+     * \return        Success
+     */
     bool importModule(ast::ImportStmt* import);
+    /**
+     * Look up a symbol from the imported module files,
+     * and add it to the global scope if it's found.
+     * \param  name Symbol name
+     * \return      Added symbol, not yet materialized, or nullptr
+     */
+    Symbol* findImportedSymbol(const std::string& name);
+    /// Is the name defined in any imported module
+    bool isImportedSymbol(const std::string& name) const;
+    /**
+     * Declare an imported function
+     * \param  s      Function from the module file
+     * \param  import Import statement
+     * \return        Created FunctionSymbol, or nullptr on error
+     */
+    FunctionSymbol* declareImportedFunction(const ModuleFileView::Entry& s,
+                                            ast::ImportStmt* import);
+    /**
+     * Declare an imported global variable
+     * \param  s      Variable from the module file
+     * \param  import Import statement
+     * \return        Created Symbol, or nullptr on error
+     */
+    Symbol* declareImportedVariable(const ModuleFileView::Entry& s,
+                                    ast::ImportStmt* import);
 
     /**
      * Log an error
@@ -104,6 +182,34 @@ private:
     FunctionSymbol* findFunction(const std::string& name, ast::Node* node,
                                  bool logError = true);
 
+    /**
+     * Find a symbol by name.
+     * Lazily imported symbols are declared in the LLVM module.
+     * \param  name Symbol name
+     * \return      Found symbol, nullptr if not found
+     */
+    Symbol* findSymbol(const std::string& name);
+    /**
+     * Declare a lazily imported symbol in the LLVM module.
+     * Does nothing if the symbol isn't lazy
+     * \param s Symbol
+     */
+    void materializeSymbol(Symbol* s);
+    /**
+     * Link the function bodies embedded in imported module files
+     * into the module as available_externally definitions,
+     * so that they can be inlined.
+     * Only functions that are used in this module are linked.
+     * \return Success
+     */
+    bool linkImportedBodies();
+    /**
+     * Generate the function evaluating an interactive expression,
+     * see codegenIncremental()
+     * \return Success
+     */
+    bool codegenResult(ast::Expr* expr);
+
     /**
      * Get the FunctionPrototypeStmt of an Node.
      * Searches parents recursively. Requires a ParentSolverVisitor run.
@@ -124,12 +230,117 @@ private:
     FunctionSymbol* declareFunction(FunctionType* type, const std::string& name,
                                     ast::FunctionPrototypeStmt* proto);
 
+    /**
+     * Find a function type, creating it if it doesn't exist yet
+     * \param  returnType Return type
+     * \param  params     Parameter types
+     * \return            FunctionType, never nullptr
+     */
+    FunctionType* findFunctionType(Type* returnType,
+                                   const std::vector<Type*>& params);
+
+    /**
+     * Find a type by name.
+     * Array (`[T; N]`) and slice (`[T]`) types are created on first use.
+     * \param  name Type name
+     * \return      Type, nullptr if not found
+     */
+    Type* findType(const std::string& name);
+
+    /**
+     * Create `llvm.loop` metadata from loop hints,
+     * to be attached to the latch branch of the loop.
+     * \param  attributes Attributes of the loop statement
+     * \param  loopID     Set to the metadata, nullptr if there are no hints
+     * \return            false if the attributes are invalid
+     */
+    bool createLoopMetadata(const std::vector<ast::Attribute>& attributes,
+                            llvm::MDNode*& loopID);
+
+    /**
+     * Check the attributes of a function, e.g. `@inline`
+     * \param  proto      Function prototype
+     * \param  attributes Set to a bitmask of FunctionSymbol::Attribute
+     * \return            false if the attributes are invalid
+     */
+    bool getFunctionAttributes(ast::FunctionPrototypeStmt* proto,
+                               uint32_t& attributes);
+    /**
+     * Add the LLVM attributes corresponding to function attributes
+     * \param f          Function
+     * \param attributes Bitmask of FunctionSymbol::Attribute
+     */
+    void applyFunctionAttributes(llvm::Function* f, uint32_t attributes);
+    /**
+     * Get the fast-math flags of floating-point operations in a function,
+     * from -ffast-math and related options, and `@fastmath`
+     * \param  attributes Bitmask of FunctionSymbol::Attribute
+     * \return            Flags
+     */
+    llvm::FastMathFlags getFastMathFlags(uint32_t attributes) const;
+    /**
+     * Check that the body of a `@pure` function doesn't write to memory,
+     * and that the body of a `@const` function doesn't access it,
+     * apart from its local variables
+     * \param  node       Function definition
+     * \param  f          Generated function
+     * \param  attributes Bitmask of FunctionSymbol::Attribute
+     * \return            false if the body violates the attributes
+     */
+    bool checkFunctionBody(ast::FunctionDefinitionStmt* node, llvm::Function* f,
+                           uint32_t attributes);
+    /**
+     * Mark calls in tail position `tail`,
+     * and check the `musttail` calls of `become`-statements.
+     * Neither is possible, if the address of a local variable may be passed
+     * to another function.
+     * \param  f Generated function
+     * \return   false if a `become`-statement is invalid
+     */
+    bool finishTailCalls(llvm::Function* f);
+
+    /**
+     * Generate a member function call, e.g. `v.sum()`.
+     * If the lhs names a type, the function is called on the type,
+     * e.g. `f32x4.load(a, 0)`.
+     * \param  node Member access expression
+     * \param  call Rhs of `node`
+     * \return      Return value of the call, nullptr on error
+     */
+    std::unique_ptr<TypedValue>
+    codegenMemberCall(ast::BinaryExpr* node, ast::ArbitraryOperandExpr* call);
+
+    /**
+     * Generate a short-circuiting `and` or `or`:
+     * the rhs is only evaluated if the lhs doesn't determine the result
+     * \param  node Logical expression
+     * \param  lhs  Value of the lhs of `node`, of type bool
+     * \return      Result, nullptr on error
+     */
+    std::unique_ptr<TypedValue>
+    codegenLogicalOperation(ast::BinaryExpr* node,
+                            std::unique_ptr<TypedValue> lhs);
+
+    /**
+     * Remove the definitions of unreachable top-level nodes
+     * from the module and the global scope
+     * \param unreachable Nodes found by reachability::findUnreachable()
+     */
+    void removeUnreachable(
+        const std::unordered_set<const ast::Node*>& unreachable);
+
     /**
      * Remove all instructions after block terminators.
      * Also add 'unreachable'-instruction if no terminators are found
      */
     void stripInstructionsAfterTerminators();
 
+    /**
+     * Set the target CPU and features given with -march, -mcpu and -mattr
+     * on every function defined in the module
+     */
+    void setTargetAttributes();
+
     /// Create 'alloca'-instruction for variable
     /**
      * Create 'alloca'-instruction in the function entry block for a variable
@@ -141,6 +352,15 @@ private:
     llvm::AllocaInst* createEntryBlockAlloca(llvm::Function* func,
                                              llvm::Type* type,
                                              const std::string& name);
+    /**
+     * Does an immutable variable (or a parameter) need storage,
+     * or can it be bound directly to its value.
+     * Arrays are accessed through a pointer,
+     * and debug info describes variables by their storage
+     * \param  type Variable type
+     * \return      true, if an alloca has to be created
+     */
+    bool needsStorage(Type* type) const;
 
     /**
      * Run type infersion on a variable definition based on its initializer.
@@ -153,6 +373,24 @@ private:
      */
     std::pair<Type*, std::unique_ptr<TypedValue>>
     inferVariableDefType(ast::VariableDefinitionExpr* node);
+    /**
+     * Generate the initializer of a `const let`, and evaluate it.
+     * The initializer is generated into a temporary function,
+     * which is run with ConstEvaluator.
+     * \param node Variable definition
+     * \return Pair of Type and TypedValue (a llvm::Constant),
+     * see inferVariableDefType(). On error both members are nullptr.
+     */
+    std::pair<Type*, std::unique_ptr<TypedValue>>
+    evaluateConstVariableDef(ast::VariableDefinitionExpr* node);
+    /**
+     * Check that a symbol can be used in a constant expression:
+     * it has to be a const function, or an immutable variable
+     * \param  node Node using the symbol
+     * \param  s    Symbol
+     * \return      Success
+     */
+    bool checkConstUse(ast::Node* node, Symbol* s) const;
 
     std::string mangleFunctionName(const std::string& name,
                                    FunctionType* type) const;
@@ -176,8 +414,26 @@ private:
 
     /// Symbol table
     std::unique_ptr<SymbolTable> symbols;
+    /// Exported symbols, written into the module file
+    std::unique_ptr<SymbolTable> exports;
     /// Type table
     std::unique_ptr<TypeTable> types;
+    /// Imported module files
+    std::vector<
+        std::pair<std::shared_ptr<const ModuleFileView>, ast::ImportStmt*>>
+        imports;
+    /// Definition of main
+    llvm::Function* mainFunction{nullptr};
+    /// Type of the expression given to codegenIncremental()
+    Type* resultType{nullptr};
+    /// Global symbols defined before the last codegenIncremental()
+    std::unordered_set<std::string> previousSymbols{};
+    /// Generating code for the body of a `const def`,
+    /// or the initializer of a `const let`, see checkConstUse()
+    bool constContext{false};
+    /// `musttail` calls of the `become`-statements in the current function,
+    /// see finishTailCalls()
+    std::vector<std::pair<llvm::CallInst*, ast::ReturnStmt*>> mustTailCalls;
 
 public:
     std::unique_ptr<TypedValue> visit(ast::Node* node) = delete;
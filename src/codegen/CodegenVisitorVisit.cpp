@@ -17,6 +17,31 @@
 
 namespace codegen
 {
+namespace
+{
+/// Can values of the type be passed to and from const functions
+bool isConstEvaluable(const Type* t)
+{
+    switch(t->kind.get())
+    {
+    case Type::VOID:
+    case Type::INT8:
+    case Type::INT16:
+    case Type::INT32:
+    case Type::INT64:
+    case Type::BOOL:
+    case Type::F32:
+    case Type::F64:
+    case Type::BYTE:
+    case Type::CHAR:
+    case Type::BCHAR:
+        return true;
+    default:
+        return false;
+    }
+}
+} // namespace
+
 std::unique_ptr<TypedValue> CodegenVisitor::visit(ast::Expr* node)
 {
     codegenWarning(node, "Unimplemented CodegenVisitor::visit({})",
@@ -128,6 +153,12 @@ std::unique_ptr<TypedValue> CodegenVisitor::visit(ast::ForStmt* node)
 
     emitDebugLocation(node);
 
+    llvm::MDNode* loopID = nullptr;
+    if(!createLoopMetadata(node->attributes, loopID))
+    {
+        return nullptr;
+    }
+
     // Push a new scope
     symbols->addBlock();
     if(info.emitDebug)
@@ -228,8 +259,13 @@ std::unique_ptr<TypedValue> CodegenVisitor::visit(ast::ForStmt* node)
     builder.CreateBr(loopStepBB);
 
     // Step branches to condition
+    // This is the latch, where the loop hints go
     builder.SetInsertPoint(loopStepBB);
-    builder.CreateBr(loopCondBB);
+    auto latch = builder.CreateBr(loopCondBB);
+    if(loopID)
+    {
+        latch->setMetadata(llvm::LLVMContext::MD_loop, loopID);
+    }
 
     builder.SetInsertPoint(loopEndBB);
 
@@ -244,14 +280,162 @@ std::unique_ptr<TypedValue> CodegenVisitor::visit(ast::ForStmt* node)
 }
 std::unique_ptr<TypedValue> CodegenVisitor::visit(ast::ForeachStmt* node)
 {
-    codegenWarning(node, "Unimplemented CodegenVisitor::visit({})",
-                   node->nodeType.get());
-    return nullptr;
+    llvm::Function* func = builder.GetInsertBlock()->getParent();
+
+    emitDebugLocation(node);
+
+    llvm::MDNode* loopID = nullptr;
+    if(!createLoopMetadata(node->attributes, loopID))
+    {
+        return nullptr;
+    }
+
+    // The loop is generated in canonical form,
+    // so that the loop optimizations (vectorization, unrolling)
+    // can compute the trip count:
+    //
+    // preheader --(empty)---
+    //   |                  |
+    //   v                  |
+    // body <---            |
+    //   |     |            |
+    //   v     |            |
+    // inc ----             |
+    //   |                  |
+    //   v                  |
+    // end <-----------------
+    //
+    // The loop variable is a single PHI in the body,
+    // the bounds are only evaluated once.
+
+    // Range bounds:
+    // foreach in BEGIN, END
+    std::unique_ptr<TypedValue> begin = nullptr;
+    if(node->begin->nodeType != ast::Node::EMPTY_EXPR)
+    {
+        begin = node->begin->accept(this);
+        if(!begin)
+        {
+            return nullptr;
+        }
+    }
+    auto end = node->iteratee->accept(this);
+    if(!end)
+    {
+        return nullptr;
+    }
+    auto type = end->type;
+    if(!type->isIntegral())
+    {
+        return codegenError(node->iteratee.get(),
+                            "Invalid foreach range: Cannot iterate over '{}'",
+                            type->getName());
+    }
+    if(!begin)
+    {
+        // Zero by default
+        begin = type->zeroInit();
+    }
+    if(!begin->type->isSameOrImplicitlyCastable(node->begin.get(), builder,
+                                                begin.get(), type))
+    {
+        return nullptr;
+    }
+
+    const auto& name = node->iterator->value;
+    if(types->isDefined(name))
+    {
+        return codegenError(
+            node->iterator.get(),
+            "Cannot name variable as '{}': Reserved typename", name);
+    }
+    if(symbols->find(name, nullptr, false) || isImportedSymbol(name))
+    {
+        return codegenError(
+            node->iterator.get(),
+            "Cannot name variable as '{}', name already defined", name);
+    }
+
+    auto preheaderBB = builder.GetInsertBlock();
+    auto bodyBB = llvm::BasicBlock::Create(context, "foreach.body", func);
+    auto incBB = llvm::BasicBlock::Create(context, "foreach.inc");
+    auto endBB = llvm::BasicBlock::Create(context, "foreach.end");
+
+    // Skip the loop if the range is empty
+    auto nonEmpty =
+        builder.CreateICmpSLT(begin->value, end->value, "foreach.nonempty");
+    builder.CreateCondBr(nonEmpty, bodyBB, endBB);
+
+    builder.SetInsertPoint(bodyBB);
+    auto phi = builder.CreatePHI(type->type, 2, name);
+    phi->addIncoming(begin->value, preheaderBB);
+
+    // Push a new scope
+    symbols->addBlock();
+    if(info.emitDebug)
+    {
+        auto d = dbuilder.createLexicalBlock(getTopDebugScope(), dfile,
+                                             node->loc.line, 0);
+        dblocks.push_back(d);
+
+        auto var = dbuilder.createAutoVariable(getTopDebugScope(), name, dfile,
+                                               node->loc.line, type->dtype);
+        dbuilder.insertDbgValueIntrinsic(
+            phi, 0, var, dbuilder.createExpression(),
+            llvm::DebugLoc::get(node->loc.line, node->loc.col,
+                                getTopDebugScope()),
+            bodyBB);
+    }
+
+    // The loop variable has no storage, see visit(VariableRefExpr*)
+    auto val =
+        std::make_unique<TypedValue>(type, phi, TypedValue::RVALUE, false);
+    auto var = std::make_unique<Symbol>(node->iterator->loc, std::move(val),
+                                        name, false);
+    symbols->getTop().insert(std::make_pair(name, std::move(var)));
+
+    auto body = node->block->accept(this);
+    if(!body)
+    {
+        return nullptr;
+    }
+    builder.CreateBr(incBB);
+
+    // Increment, and exit after the last element
+    func->getBasicBlockList().push_back(incBB);
+    builder.SetInsertPoint(incBB);
+    auto next = builder.CreateNSWAdd(phi, llvm::ConstantInt::get(type->type, 1),
+                                     name + ".next");
+    auto cont = builder.CreateICmpNE(next, end->value, "foreach.cond");
+    auto latch = builder.CreateCondBr(cont, bodyBB, endBB);
+    if(loopID)
+    {
+        latch->setMetadata(llvm::LLVMContext::MD_loop, loopID);
+    }
+    phi->addIncoming(next, incBB);
+
+    func->getBasicBlockList().push_back(endBB);
+    builder.SetInsertPoint(endBB);
+
+    // Pop scope
+    if(info.emitDebug)
+    {
+        dblocks.pop_back();
+    }
+    symbols->removeTopBlock();
+
+    return getTypedDummyValue();
 }
 std::unique_ptr<TypedValue> CodegenVisitor::visit(ast::WhileStmt* node)
 {
     llvm::Function* func = builder.GetInsertBlock()->getParent();
 
+    llvm::MDNode* loopID = nullptr;
+    if(!createLoopMetadata(node->attributes, loopID))
+    {
+        return nullptr;
+    }
+
     // Push a new scope
     emitDebugLocation(node);
     symbols->addBlock();
@@ -307,7 +491,11 @@ std::unique_ptr<TypedValue> CodegenVisitor::visit(ast::WhileStmt* node)
 
     // Body branches to condition
     builder.SetInsertPoint(bodyInsertBlock, bodyInsertPoint);
-    builder.CreateBr(condBB);
+    auto latch = builder.CreateBr(condBB);
+    if(loopID)
+    {
+        latch->setMetadata(llvm::LLVMContext::MD_loop, loopID);
+    }
 
     builder.SetInsertPoint(endBB);
 
@@ -344,11 +532,15 @@ std::unique_ptr<TypedValue> CodegenVisitor::visit(ast::IdentifierExpr* node)
     emitDebugLocation(node);
 
     // Find symbol
-    auto symbol = symbols->find(node->value);
+    auto symbol = findSymbol(node->value);
     if(!symbol)
     {
         return codegenError(node, "Undefined symbol: '{}'", node->value);
     }
+    if(constContext && !checkConstUse(node, symbol))
+    {
+        return nullptr;
+    }
     return std::make_unique<TypedValue>(symbol->getType(), symbol->value->value,
                                         TypedValue::LVALUE, symbol->isMutable);
 }
@@ -357,11 +549,24 @@ std::unique_ptr<TypedValue> CodegenVisitor::visit(ast::VariableRefExpr* node)
     emitDebugLocation(node);
 
     // Find symbol
-    auto var = symbols->find(node->value);
+    auto var = findSymbol(node->value);
     if(!var)
     {
         return codegenError(node, "Undefined variable: '{}'", node->value);
     }
+    if(constContext && !checkConstUse(node, var))
+    {
+        return nullptr;
+    }
+
+    // Values without storage (foreach loop variables, immutable locals and
+    // parameters) are used directly.
+    // They're immutable lvalues, so that assigning to them is an error
+    if(var->value->cat == TypedValue::RVALUE)
+    {
+        return std::make_unique<TypedValue>(
+            var->getType(), var->value->value, TypedValue::LVALUE, false);
+    }
 
     // Create load instruction
     auto load = builder.CreateLoad(var->getType()->type, var->value->value,
@@ -382,12 +587,25 @@ CodegenVisitor::visit(ast::VariableDefinitionExpr* node)
         return nullptr;
     }
 
+    emitDebugLocation(node);
+
+    // An immutable variable is bound directly to the value of its initializer
+    if(!node->isMutable && !needsStorage(type))
+    {
+        auto val = std::make_unique<TypedValue>(type, init->value,
+                                                TypedValue::RVALUE, false);
+        auto valclone = val->clone();
+        auto var = std::make_unique<Symbol>(node->loc, std::move(val),
+                                            node->name->value, false);
+        symbols->getTop().insert(
+            std::make_pair(node->name->value, std::move(var)));
+        return valclone;
+    }
+
     // Create alloca instruction
     auto func = builder.GetInsertBlock()->getParent();
     auto alloca = createEntryBlockAlloca(func, type->type, node->name->value);
 
-    emitDebugLocation(node);
-
     if(info.emitDebug)
     {
         auto d = dbuilder.createAutoVariable(
@@ -411,36 +629,18 @@ CodegenVisitor::visit(ast::VariableDefinitionExpr* node)
                                         node->name->value, node->isMutable);
     symbols->getTop().insert(std::make_pair(node->name->value, std::move(var)));
 
-    // Add LLVM invariant_start intrinsic
-    // This marks the variable as immutable for better optimizations
-    if(!node->isMutable)
-    {
-#if 0
-        auto intr = llvm::Intrinsic::getDeclaration(
-            module, llvm::Intrinsic::invariant_start,
-            {llvm::Type::getInt64Ty(context),
-             llvm::Type::getInt8PtrTy(context)});
-
-        auto dataLayout = llvm::DataLayout(module);
-        auto size = dataLayout.getTypeSizeInBits(type->type);
-
-        auto call = llvm::CallInst::Create(
-            intr,
-            {llvm::ConstantInt::get(llvm::Type::getInt64Ty(context), size),
-             builder.CreateLoad(alloca)});
-        builder.Insert(call);
-#endif
-    }
-
     return valclone;
 }
 std::unique_ptr<TypedValue>
 CodegenVisitor::visit(ast::GlobalVariableDefinitionExpr* node)
 {
     // Infer variable type and codegen init expression
+    // A const initializer is evaluated here
     Type* type;
     std::unique_ptr<TypedValue> init;
-    std::tie(type, init) = inferVariableDefType(node->var.get());
+    std::tie(type, init) = node->isConst
+                               ? evaluateConstVariableDef(node->var.get())
+                               : inferVariableDefType(node->var.get());
     if(!type || !init)
     {
         return nullptr;
@@ -459,9 +659,12 @@ CodegenVisitor::visit(ast::GlobalVariableDefinitionExpr* node)
     auto castedinit = llvm::dyn_cast<llvm::Constant>(init->value);
     if(!castedinit)
     {
-        return codegenError(node->var->init.get(),
-                            "Global variable has to be initialized "
-                            "with a constant expression");
+        codegenError(node->var->init.get(),
+                     "Global variable has to be initialized "
+                     "with a constant expression");
+        codegenInfo(node->var.get(), "Use 'const let' to evaluate the "
+                                     "initializer at compile time");
+        return nullptr;
     }
     llvminit = castedinit;
 
@@ -516,7 +719,7 @@ std::unique_ptr<TypedValue> CodegenVisitor::visit(ast::FunctionParameter* node)
     const auto var = node->var.get();
 
     // Find type
-    auto type = types->find(var->type->value);
+    auto type = findType(var->type->value);
     if(!type)
     {
         return codegenError(var->type.get(), "Undefined typename: '{}'",
@@ -541,6 +744,21 @@ std::unique_ptr<TypedValue> CodegenVisitor::visit(ast::FunctionParameter* node)
             var->name->value);
     }
 
+    // Parameters are immutable,
+    // so the argument can be used directly, like an immutable variable
+    if(!needsStorage(type))
+    {
+        auto arg = std::next(func->arg_begin(), node->num - 1);
+        auto val = std::make_unique<TypedValue>(type, &*arg,
+                                                TypedValue::RVALUE, false);
+        auto valclone = val->clone();
+        auto variable = std::make_unique<Symbol>(node->loc, std::move(val),
+                                                 var->name->value, false);
+        symbols->getTop().insert(
+            std::make_pair(var->name->value, std::move(variable)));
+        return valclone;
+    }
+
     // Add alloca-instruction
     auto alloca = createEntryBlockAlloca(func, llvmtype, var->name->value);
 
@@ -572,7 +790,7 @@ std::unique_ptr<TypedValue>
 CodegenVisitor::visit(ast::FunctionPrototypeStmt* node)
 {
     // Find return type
-    auto rt = types->find(node->returnType->value);
+    auto rt = findType(node->returnType->value);
     if(!rt)
     {
         return codegenError(node->returnType.get(), "Undefined typename: '{}'",
@@ -586,7 +804,7 @@ CodegenVisitor::visit(ast::FunctionPrototypeStmt* node)
     params.reserve(node->params.size());
     for(const auto& param : node->params)
     {
-        auto t = types->find(param->var->type->value);
+        auto t = findType(param->var->type->value);
         if(!t)
         {
             return codegenError(param->var->type.get(),
@@ -623,7 +841,7 @@ CodegenVisitor::visit(ast::FunctionPrototypeStmt* node)
         size_t i = 0;
         for(auto& arg : f->args())
         {
-            arg.setName(node->params[i]->var->name->value);
+            arg.setName(node->params[i++]->var->name->value);
         }
     }
 
@@ -638,7 +856,7 @@ CodegenVisitor::visit(ast::FunctionDefinitionStmt* node)
     const auto name = proto->name->value;
 
     // Find return type
-    auto returnType = types->find(proto->returnType->value);
+    auto returnType = findType(proto->returnType->value);
     if(!returnType)
     {
         return codegenError(proto->returnType.get(), "Undefined typename: '{}'",
@@ -649,7 +867,7 @@ CodegenVisitor::visit(ast::FunctionDefinitionStmt* node)
     std::vector<Type*> paramTypes;
     for(const auto& p : proto->params)
     {
-        auto t = types->find(p->var->type->value);
+        auto t = findType(p->var->type->value);
         if(!t)
         {
             return codegenError(p->var->type.get(), "Undefined typename: '{}'",
@@ -659,17 +877,7 @@ CodegenVisitor::visit(ast::FunctionDefinitionStmt* node)
     }
 
     // Find function type
-    auto functionTypeBase =
-        types->find(FunctionType::functionTypeToString(returnType, paramTypes));
-    if(!functionTypeBase)
-    {
-        // If none was found, create it
-        auto ft = std::make_unique<FunctionType>(types.get(), context, dbuilder,
-                                                 returnType, paramTypes);
-        functionTypeBase = ft.get();
-        types->insertType(std::move(ft));
-    }
-    auto functionType = dynamic_cast<FunctionType*>(functionTypeBase);
+    auto functionType = findFunctionType(returnType, paramTypes);
 
     // Declare the function
     auto func = declareFunction(functionType, name, proto);
@@ -696,6 +904,32 @@ CodegenVisitor::visit(ast::FunctionDefinitionStmt* node)
         }
     }
 
+    if(proto->isConst)
+    {
+        if(node->isDecl)
+        {
+            return codegenError(proto, "Const function '{}' has to be defined",
+                                name);
+        }
+        if(!isConstEvaluable(functionType->returnType))
+        {
+            return codegenError(proto->returnType.get(),
+                                "Const function cannot return a value of "
+                                "type '{}'",
+                                functionType->returnType->getName());
+        }
+        for(size_t i = 0; i < functionType->params.size(); ++i)
+        {
+            if(!isConstEvaluable(functionType->params[i]))
+            {
+                return codegenError(proto->params[i]->var->type.get(),
+                                    "Const function cannot take a parameter "
+                                    "of type '{}'",
+                                    functionType->params[i]->getName());
+            }
+        }
+    }
+
     // If it's a declaration
     // Don't codegen the body,
     // just declare and exit
@@ -704,6 +938,10 @@ CodegenVisitor::visit(ast::FunctionDefinitionStmt* node)
         return std::make_unique<TypedValue>(functionType, llvmfunc,
                                             TypedValue::STMTVALUE, true);
     }
+    if(proto->isMain)
+    {
+        mainFunction = llvmfunc;
+    }
 
     auto entry = llvm::BasicBlock::Create(context, "entry", llvmfunc);
     builder.SetInsertPoint(entry);
@@ -747,7 +985,11 @@ CodegenVisitor::visit(ast::FunctionDefinitionStmt* node)
                 return nullptr;
             }
 
-            // Store param value in a local variable
+            // Store param value in a local variable, if it needs one
+            if(vardef->cat == TypedValue::RVALUE)
+            {
+                continue;
+            }
             auto& llvmarg = *llvmargit;
             auto alloca = vardef->value;
             builder.CreateStore(&llvmarg, alloca);
@@ -756,7 +998,13 @@ CodegenVisitor::visit(ast::FunctionDefinitionStmt* node)
 
     // Codegen body
     emitDebugLocation(node->body.get());
-    if(!node->body->accept(this))
+    constContext = proto->isConst;
+    mustTailCalls.clear();
+    builder.setFastMathFlags(getFastMathFlags(func->attributes));
+    const auto body = node->body->accept(this);
+    builder.setFastMathFlags(getFastMathFlags(0));
+    constContext = false;
+    if(!body)
     {
         // On failure, remove function and pop scope
         llvmfunc->eraseFromParent();
@@ -783,6 +1031,18 @@ CodegenVisitor::visit(ast::FunctionDefinitionStmt* node)
         builder.CreateRetVoid();
     }
 
+    if(!checkFunctionBody(node, llvmfunc, func->attributes) ||
+       !finishTailCalls(llvmfunc))
+    {
+        llvmfunc->eraseFromParent();
+        symbols->removeTopBlock();
+        if(info.emitDebug)
+        {
+            dblocks.pop_back();
+        }
+        return nullptr;
+    }
+
 #if USE_LLVM_FUNCTION_VERIFY
     // Buggy, don't use
     if(!llvm::verifyFunction(*llvmfunc))
@@ -820,6 +1080,18 @@ std::unique_ptr<TypedValue> CodegenVisitor::visit(ast::ReturnStmt* node)
         return getTypedDummyValue();
     }
 
+    // `become` only takes a function call
+    if(node->isTailCall)
+    {
+        auto call =
+            dynamic_cast<ast::ArbitraryOperandExpr*>(node->returnValue.get());
+        if(!call || call->oper != util::OPERATORC_CALL)
+        {
+            return codegenError(node->returnValue.get(),
+                                "Invalid become: Expected a function call");
+        }
+    }
+
     // Codegen return expression
     auto ret = node->returnValue->accept(this);
     if(!ret)
@@ -829,7 +1101,7 @@ std::unique_ptr<TypedValue> CodegenVisitor::visit(ast::ReturnStmt* node)
 
     // Find function and check if types match
     auto f = getNodeFunction(node);
-    auto retType = types->find(f->returnType->value);
+    auto retType = findType(f->returnType->value);
     assert(retType);
     if(!ret->type->isSameOrImplicitlyCastable(node->returnValue.get(), builder,
                                               ret.get(), retType))
@@ -840,6 +1112,50 @@ std::unique_ptr<TypedValue> CodegenVisitor::visit(ast::ReturnStmt* node)
         return nullptr;
     }
 
+    if(node->isTailCall)
+    {
+        // Compile-time evaluated calls and implicit casts
+        // leave no call to be returned
+        auto call = llvm::dyn_cast<llvm::CallInst>(ret->value);
+        if(!call || call != &builder.GetInsertBlock()->back())
+        {
+            return codegenError(node->returnValue.get(),
+                                "Invalid become: The call can't be made "
+                                "in tail position");
+        }
+        // The callee reuses the stack frame and returns to our caller,
+        // so its arguments and return value have to be passed the same way
+        auto caller = builder.GetInsertBlock()->getParent();
+        auto callee = dynamic_cast<ast::IdentifierExpr*>(
+            dynamic_cast<ast::ArbitraryOperandExpr*>(node->returnValue.get())
+                ->operands.front()
+                .get());
+        const auto calleeName = callee ? callee->value : "<indirect>";
+        const auto& callerName = node->getFunction()->proto->name->value;
+        if(call->getFunctionType() != caller->getFunctionType())
+        {
+            return codegenError(node->returnValue.get(),
+                                "Invalid become: The parameter and return "
+                                "types of '{}' differ from those of '{}'",
+                                calleeName, callerName);
+        }
+        if(call->getCallingConv() != caller->getCallingConv())
+        {
+            return codegenError(node->returnValue.get(),
+                                "Invalid become: The calling conventions of "
+                                "'{}' and '{}' differ",
+                                calleeName, callerName);
+        }
+        call->setTailCallKind(llvm::CallInst::TCK_MustTail);
+        mustTailCalls.emplace_back(call, node);
+
+        if(call->getType()->isVoidTy())
+        {
+            builder.CreateRetVoid();
+            return ret;
+        }
+    }
+
     builder.CreateRet(ret->value);
     return ret;
 }
@@ -886,19 +1202,10 @@ std::unique_ptr<TypedValue> CodegenVisitor::visit(ast::StringLiteralExpr* node)
     auto t = types->find(node->type->value);
     assert(t);
 
+    // Equal literals share the same constant
+    auto stringPtr = types->getStringConstant(node->value);
     if(node->type->value == "cstring")
     {
-        auto stringConst =
-            llvm::ConstantDataArray::getString(context, node->value, true);
-        auto stringGlobal = new llvm::GlobalVariable(
-            *module, stringConst->getType(), true,
-            llvm::GlobalValue::InternalLinkage, stringConst, ".str");
-        auto indexConst =
-            llvm::ConstantInt::get(llvm::Type::getInt32Ty(context), 0);
-        std::vector<llvm::Constant*> indexList = {indexConst, indexConst};
-        auto stringPtr = llvm::ConstantExpr::getGetElementPtr(
-            stringConst->getType(), stringGlobal, indexList, true);
-
         return std::make_unique<TypedValue>(t, stringPtr, TypedValue::LVALUE,
                                             false);
     }
@@ -906,18 +1213,6 @@ std::unique_ptr<TypedValue> CodegenVisitor::visit(ast::StringLiteralExpr* node)
     auto stringLen = llvm::ConstantInt::get(llvm::Type::getInt64Ty(context),
                                             node->value.length());
 
-    auto stringConst =
-        llvm::ConstantDataArray::getString(context, node->value, false);
-    auto stringGlobal = new llvm::GlobalVariable(
-        *module, stringConst->getType(), true,
-        llvm::GlobalValue::InternalLinkage, stringConst, ".str");
-    auto indexConst =
-        llvm::ConstantInt::get(llvm::Type::getInt32Ty(context), 0);
-    std::vector<llvm::Constant*> indexList = {indexConst, indexConst};
-    auto stringPtr = llvm::ConstantExpr::getGetElementPtr(
-        stringConst->getType(), stringGlobal, indexList, true);
-    // auto stringPtr = builder.CreateGlobalStringPtr(node->value, ".str");
-
     auto stringFatPtr = llvm::ConstantStruct::get(
         llvm::cast<llvm::StructType>(t->type), {stringLen, stringPtr});
     assert(stringFatPtr);
@@ -953,6 +1248,15 @@ std::unique_ptr<TypedValue> CodegenVisitor::visit(ast::BinaryExpr* node)
 {
     emitDebugLocation(node);
 
+    // Member function call
+    // e.g. v.sum() or f32x4.load(a, 0)
+    if(node->oper == util::OPERATORB_MEMBER &&
+       node->rhs->nodeType == ast::Node::ARBITRARY_OPERAND_EXPR)
+    {
+        return codegenMemberCall(
+            node, dynamic_cast<ast::ArbitraryOperandExpr*>(node->rhs.get()));
+    }
+
     // Codegen lhs
     auto lhs = node->lhs->accept(this);
     if(!lhs)
@@ -960,6 +1264,38 @@ std::unique_ptr<TypedValue> CodegenVisitor::visit(ast::BinaryExpr* node)
         return nullptr;
     }
 
+    // Member access
+    // Only the length of arrays and slices is supported
+    if(node->oper == util::OPERATORB_MEMBER)
+    {
+        auto member = dynamic_cast<ast::VariableRefExpr*>(node->rhs.get());
+        auto i64 = types->find("i64");
+        auto underlying = lhs->type->getOperations()->type;
+        if(member && member->value == "len")
+        {
+            if(auto array = dynamic_cast<ArrayType*>(underlying))
+            {
+                // The length is a constant, the array isn't needed
+                auto load = llvm::dyn_cast<llvm::LoadInst>(lhs->value);
+                if(load && load->use_empty())
+                {
+                    load->eraseFromParent();
+                }
+                return std::make_unique<TypedValue>(
+                    i64, builder.getInt64(array->length), TypedValue::RVALUE,
+                    false);
+            }
+            if(underlying->kind == Type::SLICE)
+            {
+                return std::make_unique<TypedValue>(
+                    i64, builder.CreateExtractValue(lhs->value, 1, "lentmp"),
+                    TypedValue::RVALUE, false);
+            }
+        }
+        return codegenError(node, "Invalid member access on '{}'",
+                            lhs->type->getName());
+    }
+
     // Cast expression
     if(node->oper == util::OPERATORB_AS)
     {
@@ -982,7 +1318,7 @@ std::unique_ptr<TypedValue> CodegenVisitor::visit(ast::BinaryExpr* node)
         }
 
         // Find type to be casted in
-        auto t = types->find(rhs->value);
+        auto t = findType(rhs->value);
         if(!t)
         {
             return codegenError(node->rhs.get(),
@@ -994,6 +1330,17 @@ std::unique_ptr<TypedValue> CodegenVisitor::visit(ast::BinaryExpr* node)
         return lhs->type->cast(node, builder, Type::CAST, lhs.get(), t);
     }
 
+    // Logical operation
+    // Global initializers have no blocks to branch between,
+    // but they're constant, so evaluating both sides doesn't matter
+    if((node->oper == util::OPERATORB_AND ||
+        node->oper == util::OPERATORB_OR) &&
+       lhs->type->getOperations()->type->kind == Type::BOOL &&
+       builder.GetInsertBlock())
+    {
+        return codegenLogicalOperation(node, std::move(lhs));
+    }
+
     // Codegen rhs
     auto rhs = node->rhs->accept(this);
     if(!rhs)
@@ -1055,6 +1402,36 @@ CodegenVisitor::visit(ast::ArbitraryOperandExpr* node)
     emitDebugLocation(node);
 
     assert(!node->operands.empty());
+    if(node->operands[0]->nodeType == ast::Node::IDENTIFIER_EXPR)
+    {
+        // Vector construction
+        // e.g. let v = f32x4(1.0, 2.0, 3.0, 4.0);
+        auto t = types->find(
+            dynamic_cast<ast::IdentifierExpr*>(node->operands[0].get())->value);
+        if(t && t->getOperations()->type->kind == Type::VECTOR)
+        {
+            std::vector<std::unique_ptr<TypedValue>> elementsOwned;
+            std::vector<TypedValue*> elements;
+            for(auto it = node->operands.begin() + 1;
+                it != node->operands.end(); ++it)
+            {
+                auto e = (*it)->accept(this);
+                if(!e)
+                {
+                    return nullptr;
+                }
+                elements.push_back(e.get());
+                elementsOwned.push_back(std::move(e));
+            }
+            auto v = t->getOperations()->arbitraryOperation(
+                node, builder, util::OPERATORC_CALL, std::move(elements));
+            if(v)
+            {
+                v->type = t;
+            }
+            return v;
+        }
+    }
     if(node->operands[0]->nodeType == ast::Node::IDENTIFIER_EXPR &&
        node->operands.size() == 2)
     {
@@ -1105,6 +1482,114 @@ CodegenVisitor::visit(ast::ArbitraryOperandExpr* node)
                                           std::move(operands));
 }
 
+std::unique_ptr<TypedValue>
+CodegenVisitor::codegenLogicalOperation(ast::BinaryExpr* node,
+                                        std::unique_ptr<TypedValue> lhs)
+{
+    const bool isAnd = node->oper == util::OPERATORB_AND;
+
+    llvm::Function* func = builder.GetInsertBlock()->getParent();
+
+    auto rhsBB =
+        llvm::BasicBlock::Create(context, isAnd ? "and.rhs" : "or.rhs", func);
+    auto mergeBB =
+        llvm::BasicBlock::Create(context, isAnd ? "and.merge" : "or.merge");
+
+    // `false and x` is false, `true or x` is true:
+    // the rhs is skipped
+    auto lhsBB = builder.GetInsertBlock();
+    if(isAnd)
+    {
+        builder.CreateCondBr(lhs->value, rhsBB, mergeBB);
+    }
+    else
+    {
+        builder.CreateCondBr(lhs->value, mergeBB, rhsBB);
+    }
+
+    builder.SetInsertPoint(rhsBB);
+    auto rhs = node->rhs->accept(this);
+    if(!rhs)
+    {
+        return nullptr;
+    }
+    if(rhs->type->inequal(*lhs->type))
+    {
+        return codegenError(node, "BoolType binary operation operand types "
+                                  "don't match: '{}' and '{}'",
+                            lhs->type->getName(), rhs->type->getName());
+    }
+    builder.CreateBr(mergeBB);
+    // The rhs may have branched, too
+    rhsBB = builder.GetInsertBlock();
+
+    func->getBasicBlockList().push_back(mergeBB);
+    builder.SetInsertPoint(mergeBB);
+
+    auto phi =
+        builder.CreatePHI(builder.getInt1Ty(), 2, isAnd ? "andtmp" : "ortmp");
+    phi->addIncoming(isAnd ? builder.getFalse() : builder.getTrue(), lhsBB);
+    phi->addIncoming(rhs->value, rhsBB);
+
+    auto boolt = types->find("bool");
+    assert(boolt);
+    return std::make_unique<TypedValue>(boolt, phi, TypedValue::RVALUE,
+                                        false);
+}
+
+std::unique_ptr<TypedValue>
+CodegenVisitor::codegenMemberCall(ast::BinaryExpr* node,
+                                  ast::ArbitraryOperandExpr* call)
+{
+    assert(!call->operands.empty());
+    auto member = dynamic_cast<ast::IdentifierExpr*>(call->operands[0].get());
+    if(!member || call->oper != util::OPERATORC_CALL)
+    {
+        return codegenError(node, "Invalid member function call");
+    }
+
+    // Called on a type, not on a value
+    Type* type = nullptr;
+    std::unique_ptr<TypedValue> object = nullptr;
+    if(node->lhs->nodeType == ast::Node::VARIABLE_REF_EXPR)
+    {
+        type = types->find(
+            dynamic_cast<ast::VariableRefExpr*>(node->lhs.get())->value);
+    }
+    if(!type)
+    {
+        object = node->lhs->accept(this);
+        if(!object)
+        {
+            return nullptr;
+        }
+        type = object->type;
+    }
+
+    std::vector<std::unique_ptr<TypedValue>> argsOwned;
+    std::vector<TypedValue*> args;
+    for(auto it = call->operands.begin() + 1; it != call->operands.end();
+        ++it)
+    {
+        auto a = (*it)->accept(this);
+        if(!a)
+        {
+            return nullptr;
+        }
+        args.push_back(a.get());
+        argsOwned.push_back(std::move(a));
+    }
+
+    auto ret = type->getOperations()->memberCall(
+        node, builder, object.get(), member->value, std::move(args));
+    // Values of an alias keep the alias type
+    if(ret && !object && ret->type == type->getOperations()->type)
+    {
+        ret->type = type;
+    }
+    return ret;
+}
+
 std::unique_ptr<TypedValue> CodegenVisitor::visit(ast::EmptyStmt*)
 {
     return getTypedDummyValue();
@@ -1150,7 +1635,7 @@ std::unique_ptr<TypedValue> CodegenVisitor::visit(ast::ExprStmt* node)
 }
 std::unique_ptr<TypedValue> CodegenVisitor::visit(ast::AliasStmt* node)
 {
-    auto aliasee = types->find(node->aliasee->value);
+    auto aliasee = findType(node->aliasee->value);
     if(!aliasee)
     {
         return codegenError(node->aliasee.get(), "Undefined typename: '{}'",
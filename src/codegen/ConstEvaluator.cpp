@@ -0,0 +1,399 @@
+// Copyright (C) 2016-2017 Elias Kosunen
+// This file is distributed under the 3-Clause BSD License
+// See LICENSE for details
+
+#include "codegen/ConstEvaluator.h"
+#include "util/Logger.h"
+#include <llvm/IR/IntrinsicInst.h>
+#include <stdexcept>
+
+namespace codegen
+{
+llvm::Constant* ConstEvaluator::evaluate(llvm::Function* f,
+                                         llvm::Value* result)
+{
+    assert(f && result);
+    steps = 0;
+    auto value = call(f, {}, result, 0);
+    assert(value);
+    return value;
+}
+
+llvm::Constant*
+ConstEvaluator::call(llvm::Function* f,
+                     const std::vector<llvm::Constant*>& args,
+                     llvm::Value* result, size_t depth)
+{
+    if(depth > recursionLimit)
+    {
+        throw std::runtime_error(
+            fmt::format("Recursion limit of {} exceeded", recursionLimit));
+    }
+    if(f->isDeclaration())
+    {
+        throw std::runtime_error(
+            fmt::format("Body of '{}' is not available at compile time",
+                        f->getName().str()));
+    }
+
+    Frame frame;
+    {
+        assert(args.size() == f->arg_size());
+        size_t i = 0;
+        for(auto& a : f->args())
+        {
+            frame.values[&a] = args[i++];
+        }
+    }
+
+    llvm::BasicBlock* prev = nullptr;
+    llvm::BasicBlock* block = &f->getEntryBlock();
+    while(true)
+    {
+        // PHI nodes read their incoming values simultaneously
+        auto it = block->begin();
+        std::vector<std::pair<llvm::PHINode*, llvm::Constant*>> phis;
+        for(; it != block->end() && llvm::isa<llvm::PHINode>(*it); ++it)
+        {
+            auto phi = llvm::cast<llvm::PHINode>(&*it);
+            assert(prev);
+            phis.emplace_back(phi,
+                              get(frame, phi->getIncomingValueForBlock(prev)));
+        }
+        for(const auto& p : phis)
+        {
+            frame.values[p.first] = p.second;
+        }
+
+        // Instructions after the terminator are never reached
+        llvm::BasicBlock* next = nullptr;
+        for(; it != block->end() && !next; ++it)
+        {
+            if(++steps > stepLimit)
+            {
+                throw std::runtime_error(
+                    fmt::format("Step limit of {} exceeded", stepLimit));
+            }
+
+            auto& inst = *it;
+            if(auto ret = llvm::dyn_cast<llvm::ReturnInst>(&inst))
+            {
+                if(result)
+                {
+                    return get(frame, result);
+                }
+                if(auto v = ret->getReturnValue())
+                {
+                    return get(frame, v);
+                }
+                return nullptr;
+            }
+            if(auto br = llvm::dyn_cast<llvm::BranchInst>(&inst))
+            {
+                next = br->getSuccessor(0);
+                if(br->isConditional() && !isTrue(frame, br->getCondition()))
+                {
+                    next = br->getSuccessor(1);
+                }
+                continue;
+            }
+            if(llvm::isa<llvm::UnreachableInst>(&inst))
+            {
+                throw std::runtime_error("Reached unreachable code");
+            }
+            execute(frame, inst, depth);
+        }
+        if(!next)
+        {
+            throw std::runtime_error(fmt::format(
+                "Control reaches the end of '{}' without returning",
+                f->getName().str()));
+        }
+
+        prev = block;
+        block = next;
+    }
+}
+
+void ConstEvaluator::execute(Frame& frame, llvm::Instruction& inst,
+                             size_t depth)
+{
+    llvm::Constant* value = nullptr;
+    if(auto op = llvm::dyn_cast<llvm::BinaryOperator>(&inst))
+    {
+        value = binaryOperation(*op, get(frame, op->getOperand(0)),
+                                get(frame, op->getOperand(1)));
+    }
+    else if(auto cmp = llvm::dyn_cast<llvm::CmpInst>(&inst))
+    {
+        value = llvm::ConstantExpr::getCompare(cmp->getPredicate(),
+                                               get(frame, cmp->getOperand(0)),
+                                               get(frame, cmp->getOperand(1)));
+    }
+    else if(auto cast = llvm::dyn_cast<llvm::CastInst>(&inst))
+    {
+        value = llvm::ConstantExpr::getCast(
+            cast->getOpcode(), get(frame, cast->getOperand(0)),
+            cast->getType());
+    }
+    else if(auto select = llvm::dyn_cast<llvm::SelectInst>(&inst))
+    {
+        value = get(frame, isTrue(frame, select->getCondition())
+                               ? select->getTrueValue()
+                               : select->getFalseValue());
+    }
+    else if(llvm::isa<llvm::AllocaInst>(&inst))
+    {
+        // Uninitialized until stored to
+        frame.memory.erase(&inst);
+        return;
+    }
+    else if(auto l = llvm::dyn_cast<llvm::LoadInst>(&inst))
+    {
+        value = load(frame, *l);
+    }
+    else if(auto store = llvm::dyn_cast<llvm::StoreInst>(&inst))
+    {
+        auto ptr = store->getPointerOperand();
+        if(!llvm::isa<llvm::AllocaInst>(ptr))
+        {
+            throw std::runtime_error(
+                fmt::format("Cannot write to '{}' at compile time",
+                            ptr->getName().str()));
+        }
+        frame.memory[ptr] = get(frame, store->getValueOperand());
+        return;
+    }
+    else if(auto ev = llvm::dyn_cast<llvm::ExtractValueInst>(&inst))
+    {
+        value = get(frame, ev->getAggregateOperand());
+        for(auto i : ev->indices())
+        {
+            value = value->getAggregateElement(i);
+        }
+    }
+    else if(llvm::isa<llvm::DbgInfoIntrinsic>(&inst))
+    {
+        return;
+    }
+    else if(auto intr = llvm::dyn_cast<llvm::IntrinsicInst>(&inst))
+    {
+        value = intrinsic(frame, *intr);
+    }
+    else if(auto c = llvm::dyn_cast<llvm::CallInst>(&inst))
+    {
+        auto callee = c->getCalledFunction();
+        if(!callee || callee->isIntrinsic())
+        {
+            throw std::runtime_error(fmt::format(
+                "Cannot call '{}' at compile time",
+                c->getCalledValue()->getName().str()));
+        }
+
+        std::vector<llvm::Constant*> args;
+        for(auto& a : c->arg_operands())
+        {
+            args.push_back(get(frame, a));
+        }
+        value = call(callee, args, nullptr, depth + 1);
+        if(!value)
+        {
+            return;
+        }
+    }
+    else
+    {
+        throw std::runtime_error(
+            fmt::format("Operation '{}' is not supported at compile time",
+                        inst.getOpcodeName()));
+    }
+
+    assert(value);
+    if(llvm::isa<llvm::UndefValue>(value))
+    {
+        throw std::runtime_error(fmt::format(
+            "Result of operation '{}' is undefined", inst.getOpcodeName()));
+    }
+    if(llvm::isa<llvm::ConstantExpr>(value))
+    {
+        throw std::runtime_error(
+            fmt::format("Operation '{}' cannot be evaluated at compile time",
+                        inst.getOpcodeName()));
+    }
+    frame.values[&inst] = value;
+}
+
+llvm::Constant* ConstEvaluator::binaryOperation(llvm::BinaryOperator& inst,
+                                                llvm::Constant* lhs,
+                                                llvm::Constant* rhs)
+{
+    // Operations that would be undefined behavior at runtime are errors,
+    // instead of being folded to undef or a wrapped value
+    auto l = llvm::dyn_cast<llvm::ConstantInt>(lhs);
+    auto r = llvm::dyn_cast<llvm::ConstantInt>(rhs);
+    if(l && r)
+    {
+        const auto& a = l->getValue();
+        const auto& b = r->getValue();
+        bool overflow = false;
+        switch(inst.getOpcode())
+        {
+        case llvm::Instruction::Add:
+            if(inst.hasNoSignedWrap())
+            {
+                static_cast<void>(a.sadd_ov(b, overflow));
+            }
+            break;
+        case llvm::Instruction::Sub:
+            if(inst.hasNoSignedWrap())
+            {
+                static_cast<void>(a.ssub_ov(b, overflow));
+            }
+            break;
+        case llvm::Instruction::Mul:
+            if(inst.hasNoSignedWrap())
+            {
+                static_cast<void>(a.smul_ov(b, overflow));
+            }
+            break;
+        case llvm::Instruction::SDiv:
+        case llvm::Instruction::SRem:
+            if(b == 0)
+            {
+                throw std::runtime_error("Division by zero");
+            }
+            overflow = a.isMinSignedValue() && b.isAllOnesValue();
+            break;
+        case llvm::Instruction::UDiv:
+        case llvm::Instruction::URem:
+            if(b == 0)
+            {
+                throw std::runtime_error("Division by zero");
+            }
+            break;
+        case llvm::Instruction::Shl:
+        case llvm::Instruction::LShr:
+        case llvm::Instruction::AShr:
+            if(b.uge(a.getBitWidth()))
+            {
+                throw std::runtime_error("Shift amount out of range");
+            }
+            break;
+        default:
+            break;
+        }
+        if(overflow)
+        {
+            throw std::runtime_error("Signed integer overflow");
+        }
+    }
+    return llvm::ConstantExpr::get(inst.getOpcode(), lhs, rhs);
+}
+
+llvm::Constant* ConstEvaluator::intrinsic(const Frame& frame,
+                                          llvm::IntrinsicInst& inst)
+{
+    // Overflow-checked arithmetic of -ftrapv:
+    // the trap would be reached, so overflow is an error here, too
+    auto isArithmetic = [&]() {
+        switch(inst.getIntrinsicID())
+        {
+        case llvm::Intrinsic::sadd_with_overflow:
+        case llvm::Intrinsic::ssub_with_overflow:
+        case llvm::Intrinsic::smul_with_overflow:
+            return true;
+        default:
+            return false;
+        }
+    };
+    if(!isArithmetic())
+    {
+        throw std::runtime_error(fmt::format(
+            "Cannot call '{}' at compile time",
+            inst.getCalledFunction()->getName().str()));
+    }
+    auto l = llvm::dyn_cast<llvm::ConstantInt>(
+        get(frame, inst.getArgOperand(0)));
+    auto r = llvm::dyn_cast<llvm::ConstantInt>(
+        get(frame, inst.getArgOperand(1)));
+    if(!l || !r)
+    {
+        throw std::runtime_error("Operands are not constants");
+    }
+
+    bool overflow = false;
+    llvm::APInt result;
+    switch(inst.getIntrinsicID())
+    {
+    case llvm::Intrinsic::sadd_with_overflow:
+        result = l->getValue().sadd_ov(r->getValue(), overflow);
+        break;
+    case llvm::Intrinsic::ssub_with_overflow:
+        result = l->getValue().ssub_ov(r->getValue(), overflow);
+        break;
+    default:
+        result = l->getValue().smul_ov(r->getValue(), overflow);
+        break;
+    }
+    if(overflow)
+    {
+        throw std::runtime_error("Signed integer overflow");
+    }
+    return llvm::ConstantStruct::get(
+        llvm::cast<llvm::StructType>(inst.getType()),
+        {llvm::ConstantInt::get(inst.getContext(), result),
+         llvm::ConstantInt::getFalse(inst.getContext())});
+}
+
+llvm::Constant* ConstEvaluator::load(Frame& frame, llvm::LoadInst& inst)
+{
+    auto ptr = inst.getPointerOperand();
+    if(llvm::isa<llvm::AllocaInst>(ptr))
+    {
+        auto it = frame.memory.find(ptr);
+        if(it == frame.memory.end())
+        {
+            throw std::runtime_error(
+                fmt::format("Read of uninitialized variable '{}'",
+                            ptr->getName().str()));
+        }
+        return it->second;
+    }
+    if(auto g = llvm::dyn_cast<llvm::GlobalVariable>(ptr))
+    {
+        if(g->isConstant() && g->hasDefinitiveInitializer())
+        {
+            return g->getInitializer();
+        }
+    }
+    throw std::runtime_error(fmt::format("Cannot read '{}' at compile time",
+                                         ptr->getName().str()));
+}
+
+llvm::Constant* ConstEvaluator::get(const Frame& frame, llvm::Value* v)
+{
+    assert(v);
+    if(auto c = llvm::dyn_cast<llvm::Constant>(v))
+    {
+        return c;
+    }
+    auto it = frame.values.find(v);
+    if(it == frame.values.end())
+    {
+        throw std::runtime_error(
+            fmt::format("Value '{}' is not available at compile time",
+                        v->getName().str()));
+    }
+    return it->second;
+}
+
+bool ConstEvaluator::isTrue(const Frame& frame, llvm::Value* v)
+{
+    auto c = llvm::dyn_cast<llvm::ConstantInt>(get(frame, v));
+    if(!c)
+    {
+        throw std::runtime_error("Condition is not a constant");
+    }
+    return !c->isZero();
+}
+} // namespace codegen
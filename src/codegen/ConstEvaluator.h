@@ -0,0 +1,88 @@
+// Copyright (C) 2016-2017 Elias Kosunen
+// This file is distributed under the 3-Clause BSD License
+// See LICENSE for details
+
+#pragma once
+
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/IntrinsicInst.h>
+#include <unordered_map>
+#include <vector>
+
+namespace codegen
+{
+/**
+ * Evaluates code at compile time (`const def` and `const let`),
+ * by interpreting the generated LLVM IR.
+ *
+ * Supported are arithmetic (including the overflow-checked arithmetic of
+ * -ftrapv), comparisons and casts of primitive values,
+ * local variables, branches and calls to functions defined in the module.
+ * Global variables can only be read, and only if they're constant.
+ */
+class ConstEvaluator final
+{
+public:
+    /**
+     * \param pStepLimit      Maximum number of instructions to execute
+     * \param pRecursionLimit Maximum call depth
+     */
+    explicit ConstEvaluator(size_t pStepLimit = 1000000,
+                            size_t pRecursionLimit = 512)
+        : stepLimit(pStepLimit), recursionLimit(pRecursionLimit)
+    {
+    }
+
+    /**
+     * Run a function without parameters, and get the value of one of its
+     * instructions when it returns
+     * \throw std::runtime_error If the function can't be evaluated
+     * \param  f      Function to run
+     * \param  result Value in `f`
+     * \return        Value of `result`, never nullptr
+     */
+    llvm::Constant* evaluate(llvm::Function* f, llvm::Value* result);
+
+private:
+    /// Values and local variables of a function invocation
+    struct Frame
+    {
+        std::unordered_map<const llvm::Value*, llvm::Constant*> values;
+        /// Contents of allocas
+        std::unordered_map<const llvm::Value*, llvm::Constant*> memory;
+    };
+
+    /**
+     * Run a function
+     * \param  f      Function
+     * \param  args   Arguments
+     * \param  result Value in `f` to return instead of the return value,
+     * or nullptr
+     * \param  depth  Call depth
+     * \return        Return value, nullptr if `f` returns void
+     */
+    llvm::Constant* call(llvm::Function* f,
+                         const std::vector<llvm::Constant*>& args,
+                         llvm::Value* result, size_t depth);
+
+    /// Execute a non-terminator instruction
+    void execute(Frame& frame, llvm::Instruction& inst, size_t depth);
+
+    llvm::Constant* binaryOperation(llvm::BinaryOperator& inst,
+                                    llvm::Constant* lhs, llvm::Constant* rhs);
+    /// Evaluate an overflow-checking arithmetic intrinsic
+    llvm::Constant* intrinsic(const Frame& frame, llvm::IntrinsicInst& inst);
+    llvm::Constant* load(Frame& frame, llvm::LoadInst& inst);
+
+    /// Get the value of an operand
+    static llvm::Constant* get(const Frame& frame, llvm::Value* v);
+    /// Get the value of a condition
+    static bool isTrue(const Frame& frame, llvm::Value* v);
+
+    size_t stepLimit, recursionLimit;
+    /// Instructions executed
+    size_t steps{0};
+};
+} // namespace codegen
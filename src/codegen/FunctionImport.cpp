@@ -0,0 +1,140 @@
+// Copyright (C) 2016-2017 Elias Kosunen
+// This file is distributed under the 3-Clause BSD License
+// See LICENSE for details
+
+#include "codegen/FunctionImport.h"
+#include <llvm/IR/DebugInfo.h>
+#include <llvm/Linker/Linker.h>
+#include <algorithm>
+#include <string>
+#include <unordered_set>
+
+namespace codegen
+{
+namespace import
+{
+namespace
+{
+bool referencesLocalValue(const llvm::Value* v)
+{
+    if(auto g = llvm::dyn_cast<llvm::GlobalValue>(v))
+    {
+        return g->hasLocalLinkage();
+    }
+    if(auto c = llvm::dyn_cast<llvm::Constant>(v))
+    {
+        return std::any_of(c->op_begin(), c->op_end(),
+                           [](const llvm::Use& u) {
+                               return referencesLocalValue(u.get());
+                           });
+    }
+    return false;
+}
+} // namespace
+
+size_t getInstructionCount(const llvm::Function& f)
+{
+    size_t size = 0;
+    for(const auto& bb : f)
+    {
+        size += bb.size();
+    }
+    return size;
+}
+
+bool referencesLocal(const llvm::Function& f)
+{
+    for(const auto& bb : f)
+    {
+        for(const auto& inst : bb)
+        {
+            if(std::any_of(inst.op_begin(), inst.op_end(),
+                           [](const llvm::Use& u) {
+                               return referencesLocalValue(u.get());
+                           }))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool isImportable(const llvm::Function& f)
+{
+    return !f.isDeclaration() &&
+           f.getLinkage() == llvm::Function::ExternalLinkage &&
+           !referencesLocal(f);
+}
+
+void keepOnlyBodies(llvm::Module& m,
+                    const std::function<bool(const llvm::Function&)>& keep)
+{
+    for(auto& f : m)
+    {
+        if(!f.isDeclaration() && !keep(f))
+        {
+            f.deleteBody();
+        }
+    }
+    for(auto& g : m.globals())
+    {
+        if(g.hasInitializer())
+        {
+            g.setInitializer(nullptr);
+            g.setLinkage(llvm::GlobalValue::ExternalLinkage);
+        }
+    }
+
+    // Remove unused declarations
+    for(auto it = m.global_begin(); it != m.global_end();)
+    {
+        auto& g = *it++;
+        g.removeDeadConstantUsers();
+        if(g.use_empty())
+        {
+            g.eraseFromParent();
+        }
+    }
+    for(auto it = m.begin(); it != m.end();)
+    {
+        auto& f = *it++;
+        f.removeDeadConstantUsers();
+        if(f.isDeclaration() && f.use_empty())
+        {
+            f.eraseFromParent();
+        }
+    }
+    llvm::StripDebugInfo(m);
+}
+
+bool linkBodies(llvm::Module& dest, std::unique_ptr<llvm::Module> src)
+{
+    // Every function that has a definition after linking,
+    // but not before, came from src
+    std::unordered_set<std::string> defined;
+    for(auto& f : dest)
+    {
+        if(!f.isDeclaration())
+        {
+            defined.insert(f.getName());
+        }
+    }
+
+    if(llvm::Linker::linkModules(dest, std::move(src),
+                                 llvm::Linker::Flags::LinkOnlyNeeded))
+    {
+        return false;
+    }
+
+    for(auto& f : dest)
+    {
+        if(!f.isDeclaration() && defined.count(f.getName()) == 0)
+        {
+            f.setLinkage(llvm::GlobalValue::AvailableExternallyLinkage);
+        }
+    }
+    return true;
+}
+} // namespace import
+} // namespace codegen
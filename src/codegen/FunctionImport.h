@@ -0,0 +1,52 @@
+// Copyright (C) 2016-2017 Elias Kosunen
+// This file is distributed under the 3-Clause BSD License
+// See LICENSE for details
+
+#pragma once
+
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Module.h>
+#include <functional>
+#include <memory>
+
+namespace codegen
+{
+/**
+ * Helpers for moving function bodies between LLVM modules,
+ * used by module files (inlinable bodies) and ThinLTO (function imports)
+ */
+namespace import
+{
+/// Number of instructions in a function
+size_t getInstructionCount(const llvm::Function& f);
+
+/// Does the function refer to a global with local linkage,
+/// which wouldn't be visible in another module
+bool referencesLocal(const llvm::Function& f);
+
+/**
+ * Can the body of the function be copied into another module:
+ * it must be an exported definition, and mustn't refer to local symbols
+ */
+bool isImportable(const llvm::Function& f);
+
+/**
+ * Turn every function for which `keep` returns false into a declaration,
+ * turn every global variable into a declaration and
+ * remove unused declarations and debug info.
+ * \param m    Module
+ * \param keep Predicate for functions whose bodies are kept
+ */
+void keepOnlyBodies(llvm::Module& m,
+                    const std::function<bool(const llvm::Function&)>& keep);
+
+/**
+ * Link function bodies into a module as available_externally definitions.
+ * Only functions used in `dest` are linked.
+ * \param  dest Destination module
+ * \param  src  Module containing the bodies, see keepOnlyBodies()
+ * \return      Success
+ */
+bool linkBodies(llvm::Module& dest, std::unique_ptr<llvm::Module> src);
+} // namespace import
+} // namespace codegen
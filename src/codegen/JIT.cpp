@@ -0,0 +1,216 @@
+// Copyright (C) 2016-2017 Elias Kosunen
+// This file is distributed under the 3-Clause BSD License
+// See LICENSE for details
+
+#include "codegen/JIT.h"
+#include "util/Logger.h"
+#include "util/ProgramOptions.h"
+#include "util/StringUtils.h"
+#include <llvm/Analysis/TargetTransformInfo.h>
+#include <llvm/ExecutionEngine/MCJIT.h>
+#include <llvm/ExecutionEngine/SectionMemoryManager.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IR/Verifier.h>
+#include <llvm/Support/DynamicLibrary.h>
+#include <llvm/Support/Host.h>
+#include <llvm/Support/TargetSelect.h>
+#include <llvm/Target/TargetMachine.h>
+#include <llvm/Transforms/IPO.h>
+#include <llvm/Transforms/IPO/PassManagerBuilder.h>
+#include <vector>
+
+namespace codegen
+{
+namespace
+{
+llvm::CodeGenOpt::Level getCodeGenOptLevel(uint8_t optLevel)
+{
+    switch(optLevel)
+    {
+    case 0:
+        return llvm::CodeGenOpt::None;
+    case 1:
+        return llvm::CodeGenOpt::Less;
+    case 2:
+        return llvm::CodeGenOpt::Default;
+    default:
+        return llvm::CodeGenOpt::Aggressive;
+    }
+}
+} // namespace
+
+JIT::JIT(uint8_t pOptLevel, uint8_t pSizeLevel)
+    : optLevel(pOptLevel), sizeLevel(pSizeLevel)
+{
+    static const bool initialized = []() {
+        llvm::InitializeNativeTarget();
+        llvm::InitializeNativeTargetAsmPrinter();
+        llvm::InitializeNativeTargetAsmParser();
+
+        // Make the symbols of the host process (libc included) available
+        // for resolving declarations
+        llvm::sys::DynamicLibrary::LoadLibraryPermanently(nullptr);
+        return true;
+    }();
+    static_cast<void>(initialized);
+
+    // MCJIT needs a module to start with
+    auto base = std::make_unique<llvm::Module>("varuna_jit", context);
+    std::string err;
+    const auto& options = util::ProgramOptions::view();
+    engine.reset(
+        llvm::EngineBuilder(std::move(base))
+            .setEngineKind(llvm::EngineKind::JIT)
+            .setErrorStr(&err)
+            .setOptLevel(getCodeGenOptLevel(optLevel))
+            .setMCPU(options.targetCPU)
+            .setMAttrs(util::stringutils::split(options.targetFeatures, ','))
+            .setMCJITMemoryManager(
+                std::make_unique<llvm::SectionMemoryManager>())
+            .create());
+    if(!engine)
+    {
+        throw std::runtime_error(
+            fmt::format("Failed to create JIT compiler: {}", err));
+    }
+}
+
+JIT::~JIT() noexcept = default;
+
+void JIT::addModule(std::unique_ptr<llvm::Module> m)
+{
+    assert(m);
+    if(m->getTargetTriple().empty())
+    {
+        m->setTargetTriple(llvm::sys::getProcessTriple());
+    }
+    m->setDataLayout(engine->getDataLayout());
+
+    {
+        std::string err;
+        llvm::raw_string_ostream os(err);
+        if(llvm::verifyModule(*m, &os))
+        {
+            throw std::runtime_error(
+                fmt::format("Invalid module '{}': {}",
+                            m->getModuleIdentifier(), os.str()));
+        }
+    }
+
+    // Check for unresolvable symbols here,
+    // the engine would just abort.
+    // Definitions of the module are only recorded once it's accepted
+    std::vector<std::string> defined;
+    for(const auto& g : m->global_values())
+    {
+        if(!g.isDeclaration())
+        {
+            defined.push_back(g.getName().str());
+            continue;
+        }
+        if(g.use_empty())
+        {
+            continue;
+        }
+        if(auto f = llvm::dyn_cast<llvm::Function>(&g))
+        {
+            if(f->isIntrinsic())
+            {
+                continue;
+            }
+        }
+        const auto name = g.getName().str();
+        if(definitions.count(name) == 0 &&
+           !llvm::sys::DynamicLibrary::SearchForAddressOfSymbol(name))
+        {
+            throw std::runtime_error(
+                fmt::format("Undefined symbol '{}' in module '{}'", name,
+                            m->getModuleIdentifier()));
+        }
+    }
+
+    definitions.insert(defined.begin(), defined.end());
+
+    optimize(*m);
+    util::logger->debug("Adding module '{}' to the JIT",
+                        m->getModuleIdentifier());
+    engine->addModule(std::move(m));
+}
+
+uint64_t JIT::getFunctionAddress(const std::string& name)
+{
+    const auto addr = engine->getFunctionAddress(name);
+    if(engine->hasError())
+    {
+        throw std::runtime_error(fmt::format("JIT compilation failed: {}",
+                                             engine->getErrorMessage()));
+    }
+    return addr;
+}
+
+uint64_t JIT::getGlobalAddress(const std::string& name)
+{
+    const auto addr = engine->getGlobalValueAddress(name);
+    if(engine->hasError())
+    {
+        throw std::runtime_error(fmt::format("JIT compilation failed: {}",
+                                             engine->getErrorMessage()));
+    }
+    return addr;
+}
+
+int32_t JIT::runMain(const std::string& name)
+{
+    const auto addr = getFunctionAddress(name);
+    if(addr == 0)
+    {
+        throw std::runtime_error(
+            fmt::format("Main function '{}' not found", name));
+    }
+    engine->finalizeObject();
+
+    engine->runStaticConstructorsDestructors(false);
+    auto mainFunction = reinterpret_cast<int32_t (*)()>(addr);
+    const auto ret = mainFunction();
+    engine->runStaticConstructorsDestructors(true);
+    return ret;
+}
+
+void JIT::optimize(llvm::Module& m) const
+{
+    if(optLevel == 0 && sizeLevel == 0)
+    {
+        return;
+    }
+
+    llvm::PassManagerBuilder builder;
+    builder.OptLevel = optLevel;
+    builder.SizeLevel = sizeLevel;
+#if VARUNA_LLVM_VERSION >= 40
+    builder.Inliner =
+        llvm::createFunctionInliningPass(optLevel, sizeLevel, false);
+#else
+    builder.Inliner = llvm::createFunctionInliningPass(optLevel, sizeLevel);
+#endif
+    builder.LoopVectorize = optLevel > 1 && sizeLevel < 2;
+    builder.SLPVectorize = optLevel > 1 && sizeLevel < 2;
+
+    const auto analysis = engine->getTargetMachine()->getTargetIRAnalysis();
+
+    llvm::legacy::FunctionPassManager fpm(&m);
+    fpm.add(llvm::createTargetTransformInfoWrapperPass(analysis));
+    builder.populateFunctionPassManager(fpm);
+
+    llvm::legacy::PassManager mpm;
+    mpm.add(llvm::createTargetTransformInfoWrapperPass(analysis));
+    builder.populateModulePassManager(mpm);
+
+    fpm.doInitialization();
+    for(auto& f : m)
+    {
+        fpm.run(f);
+    }
+    fpm.doFinalization();
+    mpm.run(m);
+}
+} // namespace codegen
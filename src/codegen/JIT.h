@@ -0,0 +1,80 @@
+// Copyright (C) 2016-2017 Elias Kosunen
+// This file is distributed under the 3-Clause BSD License
+// See LICENSE for details
+
+#pragma once
+
+#include <llvm/ExecutionEngine/ExecutionEngine.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <memory>
+#include <string>
+#include <unordered_set>
+
+namespace codegen
+{
+/**
+ * In-process JIT compiler (`varuna -run`).
+ * Modules are optimized and compiled to machine code in memory.
+ * Functions that are declared, but not defined in any added module,
+ * are resolved from the host process,
+ * so C library functions can be called directly.
+ */
+class JIT final
+{
+public:
+    /**
+     * \param pOptLevel  Optimization level
+     * \param pSizeLevel Size optimization level
+     */
+    JIT(uint8_t pOptLevel, uint8_t pSizeLevel);
+
+    JIT(const JIT&) = delete;
+    JIT(JIT&&) noexcept = delete;
+    JIT& operator=(const JIT&) = delete;
+    JIT& operator=(JIT&&) noexcept = delete;
+    ~JIT() noexcept;
+
+    /**
+     * Optimize a module and add it to the JIT.
+     * The module is compiled when a symbol in it is first looked up.
+     * \throw std::runtime_error If the module is invalid, or refers to a
+     * symbol that can't be resolved
+     * \param m Module
+     */
+    void addModule(std::unique_ptr<llvm::Module> m);
+
+    /**
+     * Get the address of a compiled function
+     * \param  name Symbol name
+     * \return      Address, or 0 if not found
+     */
+    uint64_t getFunctionAddress(const std::string& name);
+    /**
+     * Get the address of a global variable
+     * \param  name Symbol name
+     * \return      Address, or 0 if not found
+     */
+    uint64_t getGlobalAddress(const std::string& name);
+
+    /**
+     * Run a main function, with the type `() -> i32`.
+     * Static constructors are run before it, and destructors after it.
+     * \throw std::runtime_error If the function is not found
+     * \param  name Symbol name
+     * \return      Return value of the function
+     */
+    int32_t runMain(const std::string& name);
+
+private:
+    /// Run the optimization pipeline on a module
+    void optimize(llvm::Module& m) const;
+
+    uint8_t optLevel, sizeLevel;
+    /// Context of the (empty) module the engine is created with
+    llvm::LLVMContext context;
+    std::unique_ptr<llvm::ExecutionEngine> engine{nullptr};
+    /// Symbols defined in the added modules
+    std::unordered_set<std::string> definitions;
+};
+} // namespace codegen
@@ -0,0 +1,483 @@
+// Copyright (C) 2016-2017 Elias Kosunen
+// This file is distributed under the 3-Clause BSD License
+// See LICENSE for details
+
+#include "codegen/LTOLinker.h"
+#include "codegen/FunctionImport.h"
+#include "util/Logger.h"
+#include "util/Platform.h"
+#include "util/Process.h"
+#include "util/ProgramOptions.h"
+#include "util/TmpFile.h"
+#include <llvm/IRReader/IRReader.h>
+#include <llvm/Linker/Linker.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/Transforms/IPO/Internalize.h>
+#include <algorithm>
+#include <future>
+#include <unordered_map>
+
+#if VARUNA_LLVM_VERSION == 39
+#include <llvm/Bitcode/ReaderWriter.h>
+#else
+#include <llvm/Bitcode/BitcodeWriter.h>
+#endif
+
+namespace
+{
+/**
+ * Run a tool, logging on failure
+ * \param  tool Executable
+ * \param  args Command line arguments
+ * \return      Success
+ */
+bool runTool(const std::string& tool, const std::string& args)
+{
+    util::logger->debug("Running {} {}", tool, args);
+    auto p = util::Process(tool, args);
+    if(!p.spawn())
+    {
+        util::logger->error("{} ({}) failed: {}", tool, args,
+                            p.getErrorString());
+        return false;
+    }
+    if(p.getReturnValue() != 0)
+    {
+        util::logger->error("{} ({}) failed", tool, args);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Optimize a module and compile it to a native object file
+ * \param  m        Module
+ * \param  output   Object file
+ * \param  optFlags Additional flags for opt
+ * \return          Success
+ */
+bool compileModule(const llvm::Module& m, const std::string& output,
+                   const std::string& optFlags)
+{
+    using namespace fmt::literals;
+
+    util::TmpFile input("varuna_tmp_lto", "bc");
+    {
+        std::error_code ec;
+        llvm::raw_fd_ostream os(input.getFilename(), ec,
+                                llvm::sys::fs::F_None);
+        if(ec)
+        {
+            throw std::runtime_error(
+                fmt::format("Failed to open output file: {}", ec.message()));
+        }
+        llvm::WriteBitcodeToFile(&m, os);
+        util::logger->debug("Wrote LTO module to {}", input.getFilename());
+    }
+
+    const auto execDir = util::getExecDirectory();
+    util::TmpFile optimized("varuna_tmp_lto_opt", "bc");
+    const auto opts = util::ProgramOptions::view().getOptLevel();
+    const bool optEnabled = std::get<0>(opts) > 0 || std::get<1>(opts) > 0;
+    if(optEnabled)
+    {
+        const auto opt = fmt::format("{}/varuna-opt", execDir);
+        const auto optArgs = fmt::format(
+            "{input} -o {output} {opt} {flags} -verify-each",
+            "input"_a = input.getFilename(),
+            "output"_a = optimized.getFilename(),
+            "opt"_a = util::ProgramOptions::view().optLevelToString(),
+            "flags"_a = optFlags);
+        if(!runTool(opt, optArgs))
+        {
+            return false;
+        }
+    }
+
+    const auto llc = fmt::format("{}/varuna-llc", execDir);
+    const auto llcArgs = fmt::format(
+        "-filetype=obj -o {output} {input}{opt}", "output"_a = output,
+        "input"_a =
+            optEnabled ? optimized.getFilename() : input.getFilename(),
+        "opt"_a = std::get<1>(opts) == 0 && std::get<0>(opts) > 0
+                      ? " " + util::ProgramOptions::view().optLevelToString()
+                      : "");
+    return runTool(llc, llcArgs);
+}
+
+/// Get the MD5 of a string as a hex string
+std::string hashString(llvm::StringRef str)
+{
+    llvm::MD5 md5;
+    md5.update(str);
+    llvm::MD5::MD5Result result;
+    md5.final(result);
+    llvm::SmallString<32> hex;
+    llvm::MD5::stringifyResult(result, hex);
+    return hex.str();
+}
+} // namespace
+
+namespace codegen
+{
+LTOLinker::LTOLinker(std::vector<std::string> pInputs, std::string pOutput)
+    : inputs(std::move(pInputs)), output(std::move(pOutput))
+{
+}
+
+bool LTOLinker::run()
+{
+    if(inputs.empty())
+    {
+        util::logger->error("No input files given for LTO");
+        return false;
+    }
+    if(output.empty() || output == "-")
+    {
+        util::logger->error("LTO requires an output file (-o)");
+        return false;
+    }
+
+    if(!link())
+    {
+        return false;
+    }
+    internalize();
+    return emit();
+}
+
+bool LTOLinker::link()
+{
+    module = std::make_unique<llvm::Module>("varuna-lto", context);
+    llvm::Linker linker(*module);
+
+    for(const auto& input : inputs)
+    {
+        util::logger->debug("Linking '{}'", input);
+
+        // Reads both bitcode and textual IR
+        llvm::SMDiagnostic err;
+        auto m = llvm::parseIRFile(input, err, context);
+        if(!m)
+        {
+            util::logger->error("Failed to read '{}': {}", input,
+                                err.getMessage().str());
+            return false;
+        }
+
+        // Definitions visible outside of their module are the ones marked
+        // 'export', and main.
+        // Bodies embedded from module files (available_externally) are
+        // only copies, the real definition comes from the importee
+        for(const auto& gv : m->global_values())
+        {
+            if(!gv.isDeclaration() && !gv.hasLocalLinkage() &&
+               !gv.hasAvailableExternallyLinkage())
+            {
+                exports.insert(gv.getName());
+            }
+        }
+
+        if(linker.linkInModule(std::move(m)))
+        {
+            util::logger->error("Failed to link '{}'", input);
+            return false;
+        }
+    }
+    return true;
+}
+
+void LTOLinker::internalize()
+{
+    llvm::internalizeModule(*module, [&](const llvm::GlobalValue& gv) {
+        return exports.count(gv.getName()) != 0;
+    });
+}
+
+bool LTOLinker::emit()
+{
+    if(!compileModule(*module, output, "-std-link-opts"))
+    {
+        return false;
+    }
+    util::logger->info("Wrote LTO object in '{}'", output);
+    return true;
+}
+
+constexpr uint32_t ThinLTOLinker::importInstrLimit;
+constexpr float ThinLTOLinker::importInstrEvolution;
+
+ThinLTOLinker::ThinLTOLinker(std::vector<std::string> pInputs,
+                             std::shared_ptr<util::ThreadPool> pPool,
+                             std::string pCacheDir)
+    : inputs(std::move(pInputs)), pool(std::move(pPool)),
+      cacheDir(std::move(pCacheDir))
+{
+    assert(pool);
+}
+
+std::string ThinLTOLinker::getOutputFilename(const std::string& input)
+{
+    auto dot = input.rfind('.');
+    if(dot == std::string::npos || input.find('/', dot) != std::string::npos)
+    {
+        return input + ".thinlto.o";
+    }
+    return input.substr(0, dot) + ".thinlto.o";
+}
+
+bool ThinLTOLinker::run()
+{
+    if(inputs.empty())
+    {
+        util::logger->error("No input files given for ThinLTO");
+        return false;
+    }
+
+    // Thin link: only summaries are read
+    std::vector<ModuleSummary> summaries;
+    summaries.reserve(inputs.size());
+    for(const auto& input : inputs)
+    {
+        try
+        {
+            summaries.push_back(
+                ModuleSummary::read(ModuleSummary::getFilename(input)));
+        }
+        catch(const std::exception& e)
+        {
+            util::logger->error("{}", e.what());
+            util::logger->info("Was '{}' compiled with -flto?", input);
+            return false;
+        }
+    }
+    const auto imports = computeImports(summaries);
+
+    if(!cacheDir.empty())
+    {
+        for(const auto& input : inputs)
+        {
+            auto buf = llvm::MemoryBuffer::getFile(input);
+            if(!buf)
+            {
+                util::logger->error("Failed to read '{}': {}", input,
+                                    buf.getError().message());
+                return false;
+            }
+            hashes.push_back(hashString((*buf)->getBuffer()));
+        }
+        if(auto ec = llvm::sys::fs::create_directories(cacheDir))
+        {
+            util::logger->error("Failed to create cache directory '{}': {}",
+                                cacheDir, ec.message());
+            return false;
+        }
+    }
+
+    // Backends, in parallel.
+    // Every task has to finish before returning, since they refer to this
+    std::vector<std::future<bool>> results;
+    for(size_t i = 0; i < inputs.size(); ++i)
+    {
+        results.push_back(pool->push([this, i, &imports](int) {
+            try
+            {
+                return runBackend(i, imports[i]);
+            }
+            catch(const std::exception& e)
+            {
+                util::logger->error("ThinLTO backend of '{}' failed: {}",
+                                    inputs[i], e.what());
+                return false;
+            }
+        }));
+    }
+    bool success = true;
+    for(auto& r : results)
+    {
+        success = r.get() && success;
+    }
+    return success;
+}
+
+std::vector<ThinLTOLinker::ImportList>
+ThinLTOLinker::computeImports(const std::vector<ModuleSummary>& summaries)
+{
+    using GlobalSummary = ModuleSummary::GlobalSummary;
+
+    // Where every exported symbol is defined
+    std::unordered_map<std::string, std::pair<size_t, const GlobalSummary*>>
+        definitions;
+    // Local symbols of every module
+    std::vector<std::unordered_set<std::string>> locals(summaries.size());
+    for(size_t i = 0; i < summaries.size(); ++i)
+    {
+        for(const auto& g : summaries[i].globals)
+        {
+            if(g.isExported)
+            {
+                definitions.emplace(g.name, std::make_pair(i, &g));
+            }
+            else
+            {
+                locals[i].insert(g.name);
+            }
+        }
+    }
+
+    // A function referring to a local symbol of its module
+    // can't be copied to another one
+    auto isImportable = [&](size_t module, const GlobalSummary& g) {
+        auto isLocal = [&](const std::string& name) {
+            return locals[module].count(name) != 0;
+        };
+        return g.isFunction &&
+               std::none_of(g.calls.begin(), g.calls.end(), isLocal) &&
+               std::none_of(g.refs.begin(), g.refs.end(), isLocal);
+    };
+
+    std::vector<ImportList> imports(summaries.size());
+    for(size_t i = 0; i < summaries.size(); ++i)
+    {
+        // Calls from this module, and the size limit of the callee
+        std::vector<std::pair<const std::string*, float>> worklist;
+        for(const auto& g : summaries[i].globals)
+        {
+            for(const auto& c : g.calls)
+            {
+                worklist.emplace_back(&c, static_cast<float>(importInstrLimit));
+            }
+        }
+
+        while(!worklist.empty())
+        {
+            const auto call = worklist.back();
+            worklist.pop_back();
+
+            auto def = definitions.find(*call.first);
+            if(def == definitions.end())
+            {
+                continue;
+            }
+            const auto src = def->second.first;
+            const auto& callee = *def->second.second;
+            if(src == i || static_cast<float>(callee.instCount) > call.second ||
+               !isImportable(src, callee))
+            {
+                continue;
+            }
+            if(!imports[i][src].insert(callee.name).second)
+            {
+                // Already imported
+                continue;
+            }
+
+            // Functions called by the imported one
+            // become candidates too, with a stricter limit
+            for(const auto& c : callee.calls)
+            {
+                worklist.emplace_back(&c, call.second * importInstrEvolution);
+            }
+        }
+    }
+    return imports;
+}
+
+std::string ThinLTOLinker::getCacheKey(size_t i,
+                                       const ImportList& imports) const
+{
+    std::string key = util::ProgramOptions::view().optLevelToString();
+    key.append(hashes[i]);
+    for(const auto& src : imports)
+    {
+        key.append(hashes[src.first]);
+        for(const auto& f : src.second)
+        {
+            key.append(f);
+            key.push_back('\0');
+        }
+    }
+    return hashString(key);
+}
+
+bool ThinLTOLinker::runBackend(size_t i, const ImportList& imports)
+{
+    const auto& input = inputs[i];
+    const auto output = getOutputFilename(input);
+
+    const auto cached = [&]() -> std::string {
+        if(cacheDir.empty())
+        {
+            return "";
+        }
+        return fmt::format("{}/{}.o", cacheDir, getCacheKey(i, imports));
+    }();
+    if(!cached.empty() && llvm::sys::fs::exists(cached))
+    {
+        if(auto ec = llvm::sys::fs::copy_file(cached, output))
+        {
+            util::logger->error("Failed to copy '{}' to '{}': {}", cached,
+                                output, ec.message());
+            return false;
+        }
+        util::logger->info("Wrote ThinLTO object in '{}' (cached)", output);
+        return true;
+    }
+
+    // Every backend has its own context, so that they can run in parallel
+    llvm::LLVMContext context;
+    llvm::SMDiagnostic err;
+    auto module = llvm::parseIRFile(input, err, context);
+    if(!module)
+    {
+        util::logger->error("Failed to read '{}': {}", input,
+                            err.getMessage().str());
+        return false;
+    }
+
+    for(const auto& src : imports)
+    {
+        const auto& srcFile = inputs[src.first];
+        auto srcModule = llvm::parseIRFile(srcFile, err, context);
+        if(!srcModule)
+        {
+            util::logger->error("Failed to read '{}': {}", srcFile,
+                                err.getMessage().str());
+            return false;
+        }
+        util::logger->debug("Importing {} functions from '{}' into '{}'",
+                            src.second.size(), srcFile, input);
+
+        import::keepOnlyBodies(*srcModule, [&](const llvm::Function& f) {
+            return src.second.count(f.getName()) != 0;
+        });
+        if(!import::linkBodies(*module, std::move(srcModule)))
+        {
+            util::logger->error("Failed to import functions from '{}' into "
+                                "'{}'",
+                                srcFile, input);
+            return false;
+        }
+    }
+
+    if(!compileModule(*module, output, ""))
+    {
+        return false;
+    }
+
+    if(!cached.empty())
+    {
+        // Failing to cache isn't fatal
+        if(auto ec = llvm::sys::fs::copy_file(output, cached))
+        {
+            util::logger->warn("Failed to cache '{}': {}", output,
+                               ec.message());
+        }
+    }
+    util::logger->info("Wrote ThinLTO object in '{}'", output);
+    return true;
+}
+} // namespace codegen
@@ -0,0 +1,143 @@
+// Copyright (C) 2016-2017 Elias Kosunen
+// This file is distributed under the 3-Clause BSD License
+// See LICENSE for details
+
+#pragma once
+
+#include "codegen/ModuleSummary.h"
+#include "util/ThreadPool.h"
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace codegen
+{
+/**
+ * Link-time optimizer (`varuna -lto`).
+ * Merges bitcode objects compiled with `-flto` into a single module,
+ * internalizes every symbol that isn't exported,
+ * runs the whole-program optimization pipeline on it and
+ * emits one native object file.
+ */
+class LTOLinker final
+{
+public:
+    LTOLinker(std::vector<std::string> pInputs, std::string pOutput);
+
+    LTOLinker(const LTOLinker&) = delete;
+    LTOLinker(LTOLinker&&) noexcept = delete;
+    LTOLinker& operator=(const LTOLinker&) = delete;
+    LTOLinker& operator=(LTOLinker&&) noexcept = delete;
+    ~LTOLinker() noexcept = default;
+
+    /**
+     * Run the link
+     * \return Success
+     */
+    bool run();
+
+private:
+    /**
+     * Read every input and link it into the merged module
+     * \return Success
+     */
+    bool link();
+    /// Give every symbol that isn't exported from an input internal linkage
+    void internalize();
+    /**
+     * Optimize the merged module and generate the object file
+     * \return Success
+     */
+    bool emit();
+
+    /// Input bitcode files
+    std::vector<std::string> inputs;
+    /// Output object file
+    std::string output;
+    /// LLVM context
+    llvm::LLVMContext context;
+    /// Merged module
+    std::unique_ptr<llvm::Module> module{nullptr};
+    /// Symbols exported from the inputs, preserved by internalize()
+    std::unordered_set<std::string> exports;
+};
+
+/**
+ * ThinLTO (`varuna -thinlto`).
+ * The thin link reads the summaries written next to `-flto` bitcode objects
+ * and decides which functions are imported into each module.
+ * Every module is then optimized and compiled separately on the thread pool,
+ * into `<object>.thinlto.o`.
+ * Backend results can be cached, keyed by the contents of the module and
+ * the modules it imports from, the import list and the optimization level.
+ */
+class ThinLTOLinker final
+{
+public:
+    /// Functions to import into a module:
+    /// index of the source module -> function names
+    using ImportList = std::map<size_t, std::set<std::string>>;
+
+    /// Maximum size of an imported function, in instructions
+    static constexpr uint32_t importInstrLimit = 100;
+    /// Limit multiplier for functions imported because an imported
+    /// function calls them
+    static constexpr float importInstrEvolution = 0.7f;
+
+    /**
+     * \param pInputs   Bitcode objects compiled with -flto
+     * \param pPool     Thread pool for the backends
+     * \param pCacheDir Backend cache directory, empty to disable caching
+     */
+    ThinLTOLinker(std::vector<std::string> pInputs,
+                  std::shared_ptr<util::ThreadPool> pPool,
+                  std::string pCacheDir);
+
+    ThinLTOLinker(const ThinLTOLinker&) = delete;
+    ThinLTOLinker(ThinLTOLinker&&) noexcept = delete;
+    ThinLTOLinker& operator=(const ThinLTOLinker&) = delete;
+    ThinLTOLinker& operator=(ThinLTOLinker&&) noexcept = delete;
+    ~ThinLTOLinker() noexcept = default;
+
+    /**
+     * Run the thin link and the backends
+     * \return Success
+     */
+    bool run();
+
+    /**
+     * Compute the import list of every module
+     * \param  summaries Module summaries
+     * \return           Import lists, in the same order as summaries
+     */
+    static std::vector<ImportList>
+    computeImports(const std::vector<ModuleSummary>& summaries);
+
+    /// Get the output filename of an input object
+    static std::string getOutputFilename(const std::string& input);
+
+private:
+    /**
+     * Import functions into a module, optimize it and compile it
+     * \param  i       Module index
+     * \param  imports Functions to import
+     * \return         Success
+     */
+    bool runBackend(size_t i, const ImportList& imports);
+
+    /// Get the backend cache key of a module
+    std::string getCacheKey(size_t i, const ImportList& imports) const;
+
+    /// Input bitcode files
+    std::vector<std::string> inputs;
+    std::shared_ptr<util::ThreadPool> pool;
+    std::string cacheDir;
+    /// Hashes of the contents of the inputs
+    std::vector<std::string> hashes;
+};
+} // namespace codegen
@@ -0,0 +1,82 @@
+// Copyright (C) 2016-2017 Elias Kosunen
+// This file is distributed under the 3-Clause BSD License
+// See LICENSE for details
+
+#include "codegen/ModuleCache.h"
+#include "util/Logger.h"
+#include "util/Platform.h"
+#include <sys/stat.h>
+#include <sys/types.h>
+
+namespace codegen
+{
+namespace
+{
+/// Nanoseconds since the epoch
+int64_t toNanoseconds(int64_t sec, int64_t nsec)
+{
+    return sec * 1000000000 + nsec;
+}
+} // namespace
+
+ModuleCache::ViewPtr ModuleCache::open(const std::string& filename)
+{
+    struct stat st;
+    if(::stat(filename.c_str(), &st) != 0)
+    {
+        invalidate(filename);
+        throw std::runtime_error(
+            fmt::format("Failed to open module file '{}'", filename));
+    }
+    FileStamp stamp;
+    stamp.device = static_cast<uint64_t>(st.st_dev);
+    stamp.inode = static_cast<uint64_t>(st.st_ino);
+    stamp.size = static_cast<uint64_t>(st.st_size);
+#if VARUNA_APPLE
+    stamp.mtime =
+        toNanoseconds(st.st_mtimespec.tv_sec, st.st_mtimespec.tv_nsec);
+    stamp.ctime =
+        toNanoseconds(st.st_ctimespec.tv_sec, st.st_ctimespec.tv_nsec);
+#elif VARUNA_LINUX
+    stamp.mtime = toNanoseconds(st.st_mtim.tv_sec, st.st_mtim.tv_nsec);
+    stamp.ctime = toNanoseconds(st.st_ctim.tv_sec, st.st_ctim.tv_nsec);
+#else
+    stamp.mtime = toNanoseconds(st.st_mtime, 0);
+    stamp.ctime = toNanoseconds(st.st_ctime, 0);
+#endif
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = cache.find(filename);
+        if(it != cache.end() && it->second.stamp == stamp)
+        {
+            util::logger->trace("Module file '{}' found from cache", filename);
+            return it->second.view;
+        }
+    }
+
+    // Open outside the lock, so that different modules can be opened in
+    // parallel. If two threads race on the same file, both open it and the
+    // latter one wins, which is harmless.
+    ViewPtr view = ModuleFileView::open(filename);
+    util::logger->trace("Opened module file '{}'", filename);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& entry = cache[filename];
+    entry.stamp = stamp;
+    entry.view = view;
+    return view;
+}
+
+void ModuleCache::invalidate(const std::string& filename)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    cache.erase(filename);
+}
+
+void ModuleCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    cache.clear();
+}
+} // namespace codegen
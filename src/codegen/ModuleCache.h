@@ -0,0 +1,92 @@
+// Copyright (C) 2016-2017 Elias Kosunen
+// This file is distributed under the 3-Clause BSD License
+// See LICENSE for details
+
+#pragma once
+
+#include "codegen/ModuleFile.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace codegen
+{
+/**
+ * Process-wide cache of opened module files.
+ * Entries are keyed by filename and revalidated with the
+ * device, inode, size and nanosecond modification and change times
+ * of the file.
+ * Thread-safe.
+ */
+class ModuleCache
+{
+public:
+    using ViewPtr = std::shared_ptr<const ModuleFileView>;
+
+    ModuleCache(const ModuleCache&) = delete;
+    ModuleCache& operator=(const ModuleCache&) = delete;
+    ModuleCache(ModuleCache&&) = delete;
+    ModuleCache& operator=(ModuleCache&&) = delete;
+
+    /**
+     * Get a view of a module file.
+     * Opens the file if it isn't cached or has changed since.
+     * \throw std::runtime_error On failure
+     * \param  filename Module file
+     * \return          View of the module file
+     */
+    ViewPtr open(const std::string& filename);
+
+    /**
+     * Remove a module file from the cache.
+     * Called when the file is rewritten
+     * \param filename Module file
+     */
+    void invalidate(const std::string& filename);
+
+    /// Remove every entry
+    void clear();
+
+    /// Get the global cache
+    static ModuleCache& get()
+    {
+        static ModuleCache instance;
+        return instance;
+    }
+
+private:
+    ModuleCache() = default;
+
+    /// Identity of a file on disk.
+    /// A rewritten file gets a new inode or change time,
+    /// even if its size and modification time stay the same
+    struct FileStamp
+    {
+        uint64_t device{0};
+        uint64_t inode{0};
+        uint64_t size{0};
+        /// Modification time in nanoseconds
+        int64_t mtime{0};
+        /// Status change time in nanoseconds
+        int64_t ctime{0};
+
+        bool operator==(const FileStamp& other) const
+        {
+            return device == other.device && inode == other.inode &&
+                   size == other.size && mtime == other.mtime &&
+                   ctime == other.ctime;
+        }
+    };
+
+    struct Entry
+    {
+        /// File when it was read
+        FileStamp stamp{};
+        ViewPtr view{nullptr};
+    };
+
+    std::unordered_map<std::string, Entry> cache;
+    std::mutex mutex;
+};
+} // namespace codegen
@@ -9,7 +9,13 @@
 #include "codegen/Symbol.h"
 #include "codegen/TypeTable.h"
 #include "util/Compatibility.h"
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/raw_ostream.h>
+#include <cstddef>
+#include <cstring>
 #include <fstream>
+#include <unordered_map>
 
 #include <cereal_archives.h>
 
@@ -42,6 +48,20 @@ ModuleFile::ModuleFileSymbolTable ModuleFile::read()
             "Failed to open module file '{}' for reading", modulefile));
     }
 
+    // Check for the indexed format
+    char magic[sizeof(ModuleFileView::magic)];
+    is.read(magic, sizeof(magic));
+    if(is.gcount() == sizeof(magic) &&
+       ModuleFileView::isIndexed(llvm::StringRef(magic, sizeof(magic))))
+    {
+        is.close();
+        return ModuleFileView::open(modulefile)->toSymbolTable();
+    }
+
+    // Fall back to the legacy format
+    is.clear();
+    is.seekg(0);
+
     INPUT_ARCHIVE archive(is);
 
     ModuleFileSymbolTable data;
@@ -50,19 +70,181 @@ ModuleFile::ModuleFileSymbolTable ModuleFile::read()
     return data;
 }
 
-void ModuleFile::write(ModuleFile::ModuleFileSymbolTable&& symbols)
+void ModuleFile::write(ModuleFile::ModuleFileSymbolTable&& symbols,
+                       const std::string& bitcode)
 {
-    std::ofstream os;
-    // os.exceptions(std::ios::badbit | std::ios::failbit);
-    os.open(modulefile, std::ios::binary | std::ios::out);
-    if(!os.is_open() || !os.good())
+    // Write to a temporary file first and rename it over the old one.
+    // Importers may have the old file mapped into memory,
+    // so it must not be truncated in place.
+    // The name is unique, so that concurrent writers of the same module
+    // don't overwrite each other's unfinished files
+    const auto data = encode(symbols, bitcode);
+
+    int fd = -1;
+    llvm::SmallString<128> tmpfile;
+    if(auto ec = llvm::sys::fs::createUniqueFile(modulefile + "-%%%%%%.tmp",
+                                                 fd, tmpfile))
+    {
+        throw std::runtime_error(
+            fmt::format("Failed to open module file '{}' for writing: {}",
+                        modulefile, ec.message()));
+    }
+
+    bool failed = false;
+    {
+        llvm::raw_fd_ostream os(fd, true);
+        os.write(data.data(), data.size());
+        os.close();
+        failed = os.has_error();
+        // An unhandled error is fatal when the stream is destroyed
+        os.clear_error();
+    }
+    if(failed)
     {
+        llvm::sys::fs::remove(tmpfile);
+        throw std::runtime_error(
+            fmt::format("Failed to write module file '{}'", modulefile));
+    }
+
+    if(auto ec = llvm::sys::fs::rename(tmpfile, modulefile))
+    {
+        llvm::sys::fs::remove(tmpfile);
         throw std::runtime_error(fmt::format(
-            "Failed to open module file '{}' for writing", modulefile));
+            "Failed to write module file '{}': {}", modulefile, ec.message()));
+    }
+}
+
+std::string ModuleFile::encode(const ModuleFileSymbolTable& symbols,
+                               const std::string& bitcode)
+{
+    using Word = ModuleFileView::Word;
+    using Header = ModuleFileView::Header;
+    using Record = ModuleFileView::Record;
+
+    // String table, identical strings are stored only once
+    std::string strings;
+    std::unordered_map<std::string, uint32_t> offsets;
+    auto addString = [&](const std::string& str) {
+        auto it = offsets.find(str);
+        if(it != offsets.end())
+        {
+            return it->second;
+        }
+        const auto offset = static_cast<uint32_t>(strings.size());
+        strings.append(str);
+        strings.push_back('\0');
+        offsets.insert(std::make_pair(str, offset));
+        return offset;
+    };
+    // Offset 0 is always the empty string
+    addString("");
+
+    std::vector<Record> records;
+    records.reserve(symbols.symbols.size());
+    std::vector<uint32_t> params;
+    for(const auto& s : symbols.symbols)
+    {
+        uint32_t flags = 0;
+        Record r;
+        r.hash = ModuleFileView::hash(s->name);
+        r.name = addString(s->name);
+        r.typeName = addString(s->typeName);
+        r.returnTypeName = 0;
+        r.firstParam = static_cast<uint32_t>(params.size());
+        r.paramCount = 0;
+        if(s->isFunction())
+        {
+            const auto f =
+                static_cast<const ModuleFileFunctionSymbol*>(s.get());
+            flags |= Record::FLAG_FUNCTION;
+            if(f->mangle)
+            {
+                flags |= Record::FLAG_MANGLE;
+            }
+            flags |= f->attributes << Record::attributeShift;
+            r.returnTypeName = addString(f->retTypeName);
+            r.paramCount = static_cast<uint32_t>(f->paramTypeNames.size());
+            for(const auto& p : f->paramTypeNames)
+            {
+                params.push_back(addString(p));
+            }
+        }
+        if(s->isMutable)
+        {
+            flags |= Record::FLAG_MUTABLE;
+        }
+        r.flags = flags;
+        r.line = s->loc.line;
+        r.col = s->loc.col;
+        r.len = static_cast<uint32_t>(s->loc.len);
+        records.push_back(r);
+    }
+
+    // Hash index: open addressing with linear probing.
+    // There's always at least one empty bucket, which ends a failed lookup
+    uint32_t bucketCount = 0;
+    if(!records.empty())
+    {
+        bucketCount = 1;
+        while(bucketCount < records.size() * 2)
+        {
+            bucketCount <<= 1;
+        }
+    }
+    // Bucket value is record index + 1, 0 means empty
+    std::vector<uint32_t> buckets(bucketCount, 0);
+    for(size_t i = 0; i < records.size(); ++i)
+    {
+        auto b = records[i].hash & (bucketCount - 1);
+        while(buckets[b] != 0)
+        {
+            b = (b + 1) & (bucketCount - 1);
+        }
+        buckets[b] = static_cast<uint32_t>(i + 1);
     }
 
-    OUTPUT_ARCHIVE archive(os);
-    archive(symbols);
+    Header header;
+    std::memcpy(header.magic, ModuleFileView::magic, sizeof(header.magic));
+    header.version = ModuleFileView::version;
+    header.symbolCount = static_cast<uint32_t>(records.size());
+    header.bucketCount = bucketCount;
+    header.paramCount = static_cast<uint32_t>(params.size());
+    header.sourceFile = addString(
+        symbols.symbols.empty() || !symbols.symbols[0]->loc.file
+            ? ""
+            : symbols.symbols[0]->loc.file->getFilename());
+    // Keep the bitcode 4-byte aligned
+    while(strings.size() % sizeof(Word) != 0)
+    {
+        strings.push_back('\0');
+    }
+    header.stringTableSize = static_cast<uint32_t>(strings.size());
+    header.bitcodeOffset = static_cast<uint32_t>(
+        sizeof(Header) + (buckets.size() + params.size()) * sizeof(Word) +
+        records.size() * sizeof(Record) + strings.size());
+    header.bitcodeSize = static_cast<uint32_t>(bitcode.size());
+
+    std::string data;
+    data.reserve(header.bitcodeOffset + bitcode.size());
+    auto append = [&](const void* ptr, size_t len) {
+        data.append(static_cast<const char*>(ptr), len);
+    };
+    auto appendWords = [&](const std::vector<uint32_t>& words) {
+        for(auto w : words)
+        {
+            Word word;
+            word = w;
+            append(&word, sizeof(word));
+        }
+    };
+
+    append(&header, sizeof(header));
+    appendWords(buckets);
+    append(records.data(), records.size() * sizeof(Record));
+    appendWords(params);
+    append(strings.data(), strings.size());
+    append(bitcode.data(), bitcode.size());
+    return data;
 }
 
 std::unique_ptr<ast::Stmt> ModuleFile::ModuleFileSymbol::toNode(ast::AST* ast)
@@ -105,6 +287,17 @@ ModuleFile::ModuleFileFunctionSymbol::toNode(ast::AST* ast)
         createNode<ast::IdentifierExpr>(loc, ast, std::move(retTypeName)),
         std::move(paramTypes));
     proto->mangle = mangle;
+    const auto& attributeNames = FunctionSymbol::getAttributeNames();
+    for(size_t i = 0; i < attributeNames.size(); ++i)
+    {
+        if((attributes & (1u << i)) != 0)
+        {
+            ast::Attribute a;
+            a.name = attributeNames[i];
+            a.loc = loc;
+            proto->attributes.push_back(std::move(a));
+        }
+    }
     return createNode<ast::FunctionDefinitionStmt>(
         loc, ast, std::move(proto), createNode<ast::EmptyStmt>(loc, ast));
 }
@@ -122,6 +315,7 @@ void ModuleFile::ModuleFileFunctionSymbol::fromSymbol(Symbol* s)
         paramTypeNames.push_back(pType->getName());
     }
     mangle = dynamic_cast<FunctionSymbol*>(s)->mangled;
+    attributes = dynamic_cast<FunctionSymbol*>(s)->attributes;
 }
 
 std::unique_ptr<ast::AST> ModuleFile::ModuleFileSymbolTable::toAST()
@@ -166,4 +360,249 @@ void ModuleFile::ModuleFileSymbolTable::fromSymbolTable(
         }
     }
 }
+
+const char ModuleFileView::magic[8] = {'V', 'A', 'M', 'O', 'D', 'I', 'D', 'X'};
+constexpr uint32_t ModuleFileView::version;
+constexpr uint32_t ModuleFileView::minVersion;
+constexpr uint32_t ModuleFileView::Record::attributeShift;
+
+ModuleFileView::ModuleFileView(std::unique_ptr<llvm::MemoryBuffer> buf)
+    : buffer(std::move(buf))
+{
+    const auto invalid = [&](const std::string& what) {
+        return std::runtime_error(
+            fmt::format("Invalid module file '{}': {}",
+                        buffer->getBufferIdentifier().str(), what));
+    };
+
+    const auto data = buffer->getBufferStart();
+    const auto size = buffer->getBufferSize();
+    // Version 2 header ends before the bitcode fields
+    const auto headerSize = [&]() -> size_t {
+        if(size < sizeof(Header::magic) + sizeof(Word))
+        {
+            return sizeof(Header);
+        }
+        const auto v = reinterpret_cast<const Header*>(data)->version;
+        return v < 3 ? offsetof(Header, bitcodeOffset) : sizeof(Header);
+    }();
+    if(size < headerSize || !isIndexed(buffer->getBuffer()))
+    {
+        throw invalid("Invalid header");
+    }
+    header = reinterpret_cast<const Header*>(data);
+    if(header->version < minVersion || header->version > version)
+    {
+        throw invalid(fmt::format("Unsupported version: {}",
+                                  static_cast<uint32_t>(header->version)));
+    }
+
+    const uint32_t bucketCount = header->bucketCount;
+    if((bucketCount & (bucketCount - 1)) != 0 ||
+       (header->symbolCount > 0 && bucketCount <= header->symbolCount))
+    {
+        throw invalid("Invalid symbol index");
+    }
+
+    // Locate the sections, checking that they fit in the file
+    uint64_t offset = headerSize;
+    buckets = reinterpret_cast<const Word*>(data + offset);
+    offset += static_cast<uint64_t>(bucketCount) * sizeof(Word);
+    records = reinterpret_cast<const Record*>(data + offset);
+    offset += static_cast<uint64_t>(header->symbolCount) * sizeof(Record);
+    params = reinterpret_cast<const Word*>(data + offset);
+    offset += static_cast<uint64_t>(header->paramCount) * sizeof(Word);
+    strings = data + offset;
+    offset += header->stringTableSize;
+    if(offset > size)
+    {
+        throw invalid("Unexpected end of file");
+    }
+    if(header->stringTableSize == 0 ||
+       strings[header->stringTableSize - 1] != '\0')
+    {
+        throw invalid("Invalid string table");
+    }
+
+    if(header->version >= 3 && header->bitcodeSize > 0)
+    {
+        const uint64_t bitcodeOffset = header->bitcodeOffset;
+        if(bitcodeOffset < offset ||
+           bitcodeOffset + header->bitcodeSize > size)
+        {
+            throw invalid("Invalid bitcode section");
+        }
+        bitcode = llvm::StringRef(data + bitcodeOffset, header->bitcodeSize);
+    }
+
+    sourceFile = std::make_shared<util::File>(getString(header->sourceFile));
+}
+
+std::unique_ptr<ModuleFileView>
+ModuleFileView::open(const std::string& filename)
+{
+    auto buf = llvm::MemoryBuffer::getFile(filename, -1, false);
+    if(!buf)
+    {
+        throw std::runtime_error(
+            fmt::format("Failed to open module file '{}' for reading: {}",
+                        filename, buf.getError().message()));
+    }
+    if(isIndexed((*buf)->getBuffer()))
+    {
+        return create(std::move(*buf));
+    }
+
+    // Legacy module file, convert it
+    auto symbols = ModuleFile(filename).read();
+    return create(llvm::MemoryBuffer::getMemBufferCopy(
+        ModuleFile::encode(symbols), filename));
+}
+
+std::unique_ptr<ModuleFileView>
+ModuleFileView::create(std::unique_ptr<llvm::MemoryBuffer> buffer)
+{
+    assert(buffer);
+    return std::unique_ptr<ModuleFileView>(
+        new ModuleFileView(std::move(buffer)));
+}
+
+bool ModuleFileView::isIndexed(llvm::StringRef buffer)
+{
+    return buffer.size() >= sizeof(magic) &&
+           std::memcmp(buffer.data(), magic, sizeof(magic)) == 0;
+}
+
+uint32_t ModuleFileView::hash(llvm::StringRef name)
+{
+    // 32-bit FNV-1a
+    uint32_t h = 2166136261u;
+    for(auto c : name)
+    {
+        h ^= static_cast<uint8_t>(c);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+ModuleFileView::Entry ModuleFileView::find(llvm::StringRef name) const
+{
+    const uint32_t bucketCount = header->bucketCount;
+    if(bucketCount == 0)
+    {
+        return {};
+    }
+
+    const auto h = hash(name);
+    auto b = h & (bucketCount - 1);
+    for(uint32_t probes = 0; probes < bucketCount; ++probes)
+    {
+        const uint32_t index = buckets[b];
+        if(index == 0 || index > size())
+        {
+            return {};
+        }
+        const auto& r = records[index - 1];
+        if(r.hash == h && getString(r.name) == name)
+        {
+            return Entry(this, &r);
+        }
+        b = (b + 1) & (bucketCount - 1);
+    }
+    return {};
+}
+
+ModuleFile::ModuleFileSymbolTable ModuleFileView::toSymbolTable() const
+{
+    ModuleFile::ModuleFileSymbolTable table;
+    table.symbols.reserve(size());
+    for(size_t i = 0; i < size(); ++i)
+    {
+        const auto e = (*this)[i];
+        auto s = [&]() -> std::unique_ptr<ModuleFile::ModuleFileSymbol> {
+            if(!e.isFunction())
+            {
+                return std::make_unique<ModuleFile::ModuleFileSymbol>();
+            }
+            auto f = std::make_unique<ModuleFile::ModuleFileFunctionSymbol>();
+            f->retTypeName = e.getReturnTypeName();
+            for(size_t p = 0; p < e.getParamCount(); ++p)
+            {
+                f->paramTypeNames.push_back(e.getParamTypeName(p));
+            }
+            f->mangle = e.isMangled();
+            f->attributes = e.getAttributes();
+            return std::move(f);
+        }();
+        s->typeName = e.getTypeName();
+        s->name = e.getName();
+        s->isMutable = e.isMutable();
+        s->loc = e.getLocation();
+        table.symbols.push_back(std::move(s));
+    }
+    return table;
+}
+
+llvm::StringRef ModuleFileView::getString(uint32_t offset) const
+{
+    if(offset >= header->stringTableSize)
+    {
+        return "";
+    }
+    // The string table is guaranteed to end in a null terminator
+    return llvm::StringRef(strings + offset);
+}
+
+llvm::StringRef ModuleFileView::Entry::getName() const
+{
+    return view->getString(record->name);
+}
+llvm::StringRef ModuleFileView::Entry::getTypeName() const
+{
+    return view->getString(record->typeName);
+}
+llvm::StringRef ModuleFileView::Entry::getReturnTypeName() const
+{
+    return view->getString(record->returnTypeName);
+}
+size_t ModuleFileView::Entry::getParamCount() const
+{
+    return record->paramCount;
+}
+llvm::StringRef ModuleFileView::Entry::getParamTypeName(size_t i) const
+{
+    const auto index = static_cast<uint64_t>(record->firstParam) + i;
+    if(i >= getParamCount() || index >= view->header->paramCount)
+    {
+        return "";
+    }
+    return view->getString(view->params[index]);
+}
+
+bool ModuleFileView::Entry::isFunction() const
+{
+    return (record->flags & Record::FLAG_FUNCTION) != 0;
+}
+bool ModuleFileView::Entry::isMutable() const
+{
+    return (record->flags & Record::FLAG_MUTABLE) != 0;
+}
+bool ModuleFileView::Entry::isMangled() const
+{
+    return (record->flags & Record::FLAG_MANGLE) != 0;
+}
+uint32_t ModuleFileView::Entry::getAttributes() const
+{
+    return record->flags >> Record::attributeShift;
+}
+
+util::SourceLocation ModuleFileView::Entry::getLocation() const
+{
+    util::SourceLocation loc;
+    loc.file = view->sourceFile;
+    loc.line = record->line;
+    loc.col = record->col;
+    loc.len = record->len;
+    return loc;
+}
 } // namespace codegen
@@ -8,6 +8,9 @@
 #include "ast/FunctionStmt.h"
 #include "codegen/SymbolTable.h"
 #include "util/File.h"
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/Endian.h>
+#include <llvm/Support/MemoryBuffer.h>
 #include <cereal.h>
 
 namespace codegen
@@ -49,6 +52,11 @@ public:
 
         virtual std::unique_ptr<ast::Stmt> toNode(ast::AST* ast);
         virtual void fromSymbol(Symbol* s);
+
+        virtual bool isFunction() const
+        {
+            return false;
+        }
     };
 
     struct ModuleFileFunctionSymbol : ModuleFileSymbol
@@ -56,6 +64,9 @@ public:
         std::string retTypeName;
         std::vector<std::string> paramTypeNames;
         bool mangle{true};
+        /// Bitmask of FunctionSymbol::Attribute.
+        /// Not present in the legacy format
+        uint32_t attributes{0};
 
         template <class Archive>
         void serialize(Archive& archive)
@@ -67,6 +78,11 @@ public:
 
         std::unique_ptr<ast::Stmt> toNode(ast::AST* ast) override;
         void fromSymbol(Symbol* s) override;
+
+        bool isFunction() const override
+        {
+            return true;
+        }
     };
 
     struct ModuleFileSymbolTable
@@ -93,10 +109,200 @@ public:
 
     explicit ModuleFile(std::string file);
 
+    /**
+     * Read and decode the whole module file.
+     * Supports both the indexed and the legacy (cereal) format.
+     * \throw std::runtime_error On failure
+     * \return Symbols of the module
+     */
     ModuleFileSymbolTable read();
-    void write(ModuleFileSymbolTable&& symbols);
+    /**
+     * Write the module file in the indexed format
+     * \throw std::runtime_error On failure
+     * \param symbols Symbols to write
+     * \param bitcode LLVM bitcode of inlinable function bodies, may be empty
+     */
+    void write(ModuleFileSymbolTable&& symbols, const std::string& bitcode = "");
+
+    /**
+     * Encode symbols in the indexed format
+     * \param  symbols Symbols to encode
+     * \param  bitcode LLVM bitcode of inlinable function bodies, may be empty
+     * \return         Encoded file contents
+     */
+    static std::string encode(const ModuleFileSymbolTable& symbols,
+                              const std::string& bitcode = "");
 
 private:
     std::string modulefile;
 };
+
+/**
+ * Read-only view of a module file.
+ *
+ * Indexed module files are memory mapped and accessed in place:
+ * a header, a hash index of symbol names, fixed-size symbol records,
+ * a list of parameter type names, a string table and, since version 3,
+ * LLVM bitcode containing the bodies of small exported functions,
+ * which importers can inline.
+ * Legacy (cereal) module files are converted to the same representation
+ * when they are opened.
+ */
+class ModuleFileView
+{
+public:
+    /// All integers are stored as 32-bit little-endian
+    using Word = llvm::support::ulittle32_t;
+
+    /// Current module file format version
+    static constexpr uint32_t version = 3;
+    /// Oldest supported indexed format version
+    static constexpr uint32_t minVersion = 2;
+    /// Magic bytes in the beginning of an indexed module file
+    static const char magic[8];
+
+    /// File header
+    struct Header
+    {
+        char magic[8];
+        Word version;
+        Word symbolCount;
+        /// Number of hash buckets, a power of two or zero
+        Word bucketCount;
+        Word paramCount;
+        Word stringTableSize;
+        /// Source filename, offset to the string table
+        Word sourceFile;
+        /// Offset of the embedded bitcode from the beginning of the file.
+        /// Not present in version 2
+        Word bitcodeOffset;
+        /// Size of the embedded bitcode, zero if there's none
+        Word bitcodeSize;
+    };
+
+    /// Symbol record.
+    /// Strings are offsets to the string table
+    struct Record
+    {
+        enum Flags : uint32_t
+        {
+            FLAG_FUNCTION = 1 << 0,
+            FLAG_MUTABLE = 1 << 1,
+            FLAG_MANGLE = 1 << 2
+        };
+        /// Function attributes (FunctionSymbol::Attribute) are stored
+        /// in the flags, starting from this bit
+        static constexpr uint32_t attributeShift = 3;
+
+        Word hash;
+        Word name;
+        Word typeName;
+        Word returnTypeName;
+        /// Index of the first parameter type name in the parameter list
+        Word firstParam;
+        Word paramCount;
+        Word flags;
+        Word line;
+        Word col;
+        Word len;
+    };
+
+    /// A symbol in the module file
+    class Entry
+    {
+    public:
+        Entry() = default;
+        Entry(const ModuleFileView* v, const Record* r) : view(v), record(r)
+        {
+        }
+
+        explicit operator bool() const
+        {
+            return record != nullptr;
+        }
+
+        llvm::StringRef getName() const;
+        llvm::StringRef getTypeName() const;
+        llvm::StringRef getReturnTypeName() const;
+        size_t getParamCount() const;
+        llvm::StringRef getParamTypeName(size_t i) const;
+
+        bool isFunction() const;
+        bool isMutable() const;
+        bool isMangled() const;
+        /// Bitmask of FunctionSymbol::Attribute
+        uint32_t getAttributes() const;
+
+        util::SourceLocation getLocation() const;
+
+    private:
+        const ModuleFileView* view{nullptr};
+        const Record* record{nullptr};
+    };
+
+    /**
+     * Open a module file.
+     * Indexed files are mapped, legacy files are converted.
+     * \throw std::runtime_error On failure
+     * \param  filename Module file
+     * \return          View of the file
+     */
+    static std::unique_ptr<ModuleFileView> open(const std::string& filename);
+    /**
+     * Create a view of encoded module file contents
+     * \throw std::runtime_error If the contents are invalid
+     * \param  buffer Contents
+     * \return        View of the contents
+     */
+    static std::unique_ptr<ModuleFileView>
+    create(std::unique_ptr<llvm::MemoryBuffer> buffer);
+
+    /// Is the buffer in the indexed format
+    static bool isIndexed(llvm::StringRef buffer);
+
+    /// Number of symbols
+    size_t size() const
+    {
+        return header->symbolCount;
+    }
+    /// Get symbol by index
+    Entry operator[](size_t i) const
+    {
+        assert(i < size());
+        return Entry(this, records + i);
+    }
+
+    /**
+     * Find a symbol by name using the hash index
+     * \param  name Symbol name
+     * \return      Found symbol, or an empty Entry if not found
+     */
+    Entry find(llvm::StringRef name) const;
+
+    /// Decode the whole file
+    ModuleFile::ModuleFileSymbolTable toSymbolTable() const;
+
+    /// Embedded bitcode of inlinable function bodies, empty if there's none
+    llvm::StringRef getBitcode() const
+    {
+        return bitcode;
+    }
+
+    /// Hash function used by the index
+    static uint32_t hash(llvm::StringRef name);
+
+private:
+    explicit ModuleFileView(std::unique_ptr<llvm::MemoryBuffer> buf);
+
+    llvm::StringRef getString(uint32_t offset) const;
+
+    std::unique_ptr<llvm::MemoryBuffer> buffer;
+    const Header* header{nullptr};
+    const Word* buckets{nullptr};
+    const Record* records{nullptr};
+    const Word* params{nullptr};
+    const char* strings{nullptr};
+    llvm::StringRef bitcode;
+    std::shared_ptr<util::File> sourceFile{nullptr};
+};
 } // namespace codegen
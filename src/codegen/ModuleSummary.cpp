@@ -0,0 +1,119 @@
+// Copyright (C) 2016-2017 Elias Kosunen
+// This file is distributed under the 3-Clause BSD License
+// See LICENSE for details
+
+#include "codegen/ModuleSummary.h"
+#include "codegen/FunctionImport.h"
+#include "util/Logger.h"
+#include <llvm/IR/CallSite.h>
+#include <fstream>
+#include <set>
+
+#include <cereal_archives.h>
+
+namespace codegen
+{
+namespace
+{
+/// Add the names of every global referred to by a value
+void collectRefs(const llvm::Value* v, std::set<std::string>& refs)
+{
+    if(auto g = llvm::dyn_cast<llvm::GlobalValue>(v))
+    {
+        refs.insert(g->getName());
+        return;
+    }
+    if(auto c = llvm::dyn_cast<llvm::Constant>(v))
+    {
+        for(const auto& op : c->operands())
+        {
+            collectRefs(op.get(), refs);
+        }
+    }
+}
+} // namespace
+
+ModuleSummary ModuleSummary::build(const llvm::Module& m)
+{
+    ModuleSummary summary;
+    for(const auto& f : m)
+    {
+        // Bodies imported from module files are only copies,
+        // the definition belongs to the importee
+        if(f.isDeclaration() || f.hasAvailableExternallyLinkage())
+        {
+            continue;
+        }
+
+        std::set<std::string> calls, refs;
+        for(const auto& bb : f)
+        {
+            for(const auto& inst : bb)
+            {
+                llvm::ImmutableCallSite cs(&inst);
+                const auto callee = cs ? cs.getCalledFunction() : nullptr;
+                if(callee)
+                {
+                    calls.insert(callee->getName());
+                }
+                for(const auto& op : inst.operands())
+                {
+                    if(op.get() != callee)
+                    {
+                        collectRefs(op.get(), refs);
+                    }
+                }
+            }
+        }
+
+        GlobalSummary s;
+        s.name = f.getName();
+        s.isFunction = true;
+        s.isExported = !f.hasLocalLinkage();
+        s.instCount = static_cast<uint32_t>(import::getInstructionCount(f));
+        s.calls.assign(calls.begin(), calls.end());
+        s.refs.assign(refs.begin(), refs.end());
+        summary.globals.push_back(std::move(s));
+    }
+    for(const auto& g : m.globals())
+    {
+        if(g.isDeclaration())
+        {
+            continue;
+        }
+        GlobalSummary s;
+        s.name = g.getName();
+        s.isExported = !g.hasLocalLinkage();
+        summary.globals.push_back(std::move(s));
+    }
+    return summary;
+}
+
+ModuleSummary ModuleSummary::read(const std::string& filename)
+{
+    std::ifstream is(filename, std::ios::binary | std::ios::in);
+    if(!is.is_open() || !is.good())
+    {
+        throw std::runtime_error(fmt::format(
+            "Failed to open module summary '{}' for reading", filename));
+    }
+
+    cereal::BinaryInputArchive archive(is);
+    ModuleSummary summary;
+    archive(summary);
+    return summary;
+}
+
+void ModuleSummary::write(const std::string& filename) const
+{
+    std::ofstream os(filename, std::ios::binary | std::ios::out);
+    if(!os.is_open() || !os.good())
+    {
+        throw std::runtime_error(fmt::format(
+            "Failed to open module summary '{}' for writing", filename));
+    }
+
+    cereal::BinaryOutputArchive archive(os);
+    archive(*this);
+}
+} // namespace codegen
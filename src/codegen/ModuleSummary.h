@@ -0,0 +1,81 @@
+// Copyright (C) 2016-2017 Elias Kosunen
+// This file is distributed under the 3-Clause BSD License
+// See LICENSE for details
+
+#pragma once
+
+#include <llvm/IR/Module.h>
+#include <cereal.h>
+#include <string>
+#include <vector>
+
+namespace codegen
+{
+/**
+ * Summary of a module for ThinLTO.
+ * Written next to `-flto` bitcode objects (`<object>.vasum`),
+ * so that the thin link can compute function imports
+ * without reading any bitcode.
+ */
+struct ModuleSummary
+{
+    /// Summary of a function or a global variable
+    struct GlobalSummary
+    {
+        std::string name;
+        bool isFunction{false};
+        /// Visible outside the module
+        bool isExported{false};
+        /// Number of instructions, functions only
+        uint32_t instCount{0};
+        /// Directly called functions
+        std::vector<std::string> calls;
+        /// Other referenced globals
+        std::vector<std::string> refs;
+
+        template <class Archive>
+        void serialize(Archive& archive)
+        {
+            archive(CEREAL_NVP(name), CEREAL_NVP(isFunction),
+                    CEREAL_NVP(isExported), CEREAL_NVP(instCount),
+                    CEREAL_NVP(calls), CEREAL_NVP(refs));
+        }
+    };
+
+    /// Definitions in the module
+    std::vector<GlobalSummary> globals;
+
+    template <class Archive>
+    void serialize(Archive& archive)
+    {
+        archive(CEREAL_NVP(globals));
+    }
+
+    /**
+     * Summarize a module
+     * \param  m Module
+     * \return   Summary
+     */
+    static ModuleSummary build(const llvm::Module& m);
+
+    /**
+     * Read a summary file
+     * \throw std::runtime_error On failure
+     * \param  filename Summary file
+     * \return          Summary
+     */
+    static ModuleSummary read(const std::string& filename);
+    /**
+     * Write a summary file
+     * \throw std::runtime_error On failure
+     * \param filename Summary file
+     */
+    void write(const std::string& filename) const;
+
+    /// Get the summary filename of a bitcode object
+    static std::string getFilename(const std::string& object)
+    {
+        return object + ".vasum";
+    }
+};
+} // namespace codegen
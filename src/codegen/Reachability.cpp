@@ -0,0 +1,98 @@
+// Copyright (C) 2016-2017 Elias Kosunen
+// This file is distributed under the 3-Clause BSD License
+// See LICENSE for details
+
+#include "codegen/Reachability.h"
+#include "ast/Expr.h"
+#include "ast/FunctionStmt.h"
+#include "ast/ReferenceVisitor.h"
+#include "ast/Stmt.h"
+#include <unordered_map>
+#include <vector>
+
+namespace codegen
+{
+namespace reachability
+{
+std::string getRemovableName(const ast::Node* node)
+{
+    if(node->nodeType == ast::Node::FUNCTION_DEF_STMT)
+    {
+        auto def = static_cast<const ast::FunctionDefinitionStmt*>(node);
+        const auto proto = def->proto.get();
+        if(def->isDecl || proto->isExport || proto->isMain)
+        {
+            return {};
+        }
+        return proto->name->value;
+    }
+    if(node->nodeType == ast::Node::EXPR_STMT)
+    {
+        auto expr = static_cast<const ast::ExprStmt*>(node)->expr.get();
+        if(expr->nodeType != ast::Node::GLOBAL_VARIABLE_DEFINITION_EXPR)
+        {
+            return {};
+        }
+        auto global =
+            static_cast<const ast::GlobalVariableDefinitionExpr*>(expr);
+        if(global->isExport)
+        {
+            return {};
+        }
+        return global->var->name->value;
+    }
+    return {};
+}
+
+std::unordered_set<const ast::Node*> findUnreachable(ast::BlockStmt* root)
+{
+    // Functions can be overloaded, every overload is kept
+    std::unordered_map<std::string, std::vector<ast::Node*>> definitions;
+    std::unordered_set<const ast::Node*> reachable;
+    std::vector<ast::Node*> worklist;
+    for(auto& child : root->nodes)
+    {
+        const auto name = getRemovableName(child.get());
+        if(name.empty())
+        {
+            reachable.insert(child.get());
+            worklist.push_back(child.get());
+            continue;
+        }
+        definitions[name].push_back(child.get());
+    }
+
+    ast::ReferenceVisitor visitor;
+    while(!worklist.empty())
+    {
+        auto node = worklist.back();
+        worklist.pop_back();
+        for(const auto& name : visitor.run(node))
+        {
+            auto it = definitions.find(name);
+            if(it == definitions.end())
+            {
+                continue;
+            }
+            for(auto def : it->second)
+            {
+                if(reachable.insert(def).second)
+                {
+                    worklist.push_back(def);
+                }
+            }
+        }
+    }
+
+    std::unordered_set<const ast::Node*> unreachable;
+    for(auto& child : root->nodes)
+    {
+        if(reachable.count(child.get()) == 0)
+        {
+            unreachable.insert(child.get());
+        }
+    }
+    return unreachable;
+}
+} // namespace reachability
+} // namespace codegen
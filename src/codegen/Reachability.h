@@ -0,0 +1,38 @@
+// Copyright (C) 2016-2017 Elias Kosunen
+// This file is distributed under the 3-Clause BSD License
+// See LICENSE for details
+
+#pragma once
+
+#include "ast/FwdDecl.h"
+#include <string>
+#include <unordered_set>
+
+namespace codegen
+{
+/**
+ * Reachability of the top-level definitions of a module,
+ * so that code isn't generated for ones that are never used
+ */
+namespace reachability
+{
+/**
+ * Get the name defined by a top-level node, if it can be left out of the
+ * module when it's not referred to: a function definition or a global
+ * variable that isn't exported, or `main`.
+ * \param  node Top-level node
+ * \return      Defined name, empty if the node is always generated
+ */
+std::string getRemovableName(const ast::Node* node);
+
+/**
+ * Find the top-level definitions that can't be reached from the ones that
+ * are always generated (`main`, exported symbols, declarations, imports),
+ * through the names they refer to.
+ * Any reference to a function counts, whether it's called or not
+ * \param  root Global node of the AST
+ * \return      Unreachable top-level nodes
+ */
+std::unordered_set<const ast::Node*> findUnreachable(ast::BlockStmt* root);
+} // namespace reachability
+} // namespace codegen
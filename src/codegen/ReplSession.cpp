@@ -0,0 +1,226 @@
+// Copyright (C) 2016-2017 Elias Kosunen
+// This file is distributed under the 3-Clause BSD License
+// See LICENSE for details
+
+#include "codegen/ReplSession.h"
+#include "core/lexer/Lexer.h"
+#include "core/parser/Parser.h"
+#include <utf8.h>
+#include <iterator>
+
+namespace codegen
+{
+ReplSession::ReplSession(uint8_t pOptLevel, uint8_t pSizeLevel)
+    : info(std::make_shared<util::File>("<repl>"), pOptLevel, pSizeLevel,
+           false),
+      base(std::make_unique<llvm::Module>("repl", context)),
+      codegen(std::make_unique<CodegenVisitor>(context, base.get(), info)),
+      jit(std::make_unique<JIT>(pOptLevel, pSizeLevel))
+{
+}
+
+ReplSession::~ReplSession() noexcept = default;
+
+bool ReplSession::eval(const std::string& input)
+{
+    result.clear();
+
+    auto file = std::make_shared<util::File>("<repl>");
+    file->setContent(input);
+
+    core::lexer::Lexer lexer(file);
+    const auto tokens = lexer.run();
+    if(lexer.getError())
+    {
+        return false;
+    }
+
+    core::parser::Parser parser(file, tokens);
+    auto expr = parser.runInteractive();
+    if(parser.getError())
+    {
+        return false;
+    }
+    std::shared_ptr<ast::AST> ast = parser.retrieveAST();
+    if(!expr && ast->globalNode->nodes.empty())
+    {
+        return true;
+    }
+
+    const auto name = fmt::format("repl{}", count++);
+    auto module = std::make_unique<llvm::Module>(name, context);
+    if(!codegen->codegenIncremental(ast.get(), module.get(), expr.get()))
+    {
+        return false;
+    }
+    const auto resultType = codegen->getResultType();
+
+    std::vector<std::string> defined;
+    const auto swaps = makeSwappable(*module, defined);
+    try
+    {
+        jit->addModule(std::move(module));
+    }
+    catch(const std::runtime_error& e)
+    {
+        // Nothing from a rejected module ends up in the session
+        util::logger->error(e.what());
+        codegen->rollbackIncremental();
+        return false;
+    }
+    asts.push_back(std::move(ast));
+    for(const auto& f : defined)
+    {
+        ++versions[f];
+    }
+
+    try
+    {
+        for(const auto& s : swaps)
+        {
+            auto ptr = reinterpret_cast<void**>(jit->getGlobalAddress(s.first));
+            assert(ptr);
+            *ptr = reinterpret_cast<void*>(jit->getFunctionAddress(s.second));
+            util::logger->debug("Redefined {} as {}", s.first, s.second);
+        }
+
+        if(!expr)
+        {
+            return true;
+        }
+
+        auto exprFunction = reinterpret_cast<void (*)()>(
+            jit->getFunctionAddress(name + ".expr"));
+        assert(exprFunction);
+        exprFunction();
+
+        if(resultType)
+        {
+            const auto value = reinterpret_cast<const void*>(
+                jit->getGlobalAddress(name + ".result"));
+            assert(value);
+            result = fmt::format("{}: {}", formatValue(resultType, value),
+                                 resultType->getName());
+        }
+    }
+    catch(const std::runtime_error& e)
+    {
+        util::logger->error(e.what());
+        return false;
+    }
+    return true;
+}
+
+std::vector<std::pair<std::string, std::string>>
+ReplSession::makeSwappable(llvm::Module& m, std::vector<std::string>& names)
+{
+    std::vector<llvm::Function*> defined;
+    for(auto& f : m)
+    {
+        if(!f.isDeclaration() && !f.hasLocalLinkage() &&
+           f.getName() != m.getModuleIdentifier() + ".expr")
+        {
+            defined.push_back(&f);
+        }
+    }
+
+    std::vector<std::pair<std::string, std::string>> redefined;
+    for(auto f : defined)
+    {
+        const auto name = f->getName().str();
+        names.push_back(name);
+        // Committed to versions once the module is accepted
+        const auto it = versions.find(name);
+        const auto version = (it == versions.end() ? 0 : it->second) + 1;
+        const auto impl = fmt::format("{}.{}", name, version);
+        f->setName(impl);
+        if(version > 1)
+        {
+            // Calls in this module go through the stub too
+            f->replaceAllUsesWith(llvm::Function::Create(
+                f->getFunctionType(), llvm::Function::ExternalLinkage, name,
+                &m));
+            redefined.emplace_back(name + ".ptr", impl);
+            continue;
+        }
+
+        auto stub =
+            llvm::Function::Create(f->getFunctionType(),
+                                   llvm::Function::ExternalLinkage, name, &m);
+        f->replaceAllUsesWith(stub);
+        auto ptr = new llvm::GlobalVariable(m, f->getType(), false,
+                                            llvm::GlobalValue::ExternalLinkage,
+                                            f, name + ".ptr");
+        llvm::IRBuilder<> builder(
+            llvm::BasicBlock::Create(context, "entry", stub));
+        std::vector<llvm::Value*> args;
+        for(auto& a : stub->args())
+        {
+            args.push_back(&a);
+        }
+        auto call = builder.CreateCall(builder.CreateLoad(ptr), args);
+        call->setTailCall();
+        if(stub->getReturnType()->isVoidTy())
+        {
+            builder.CreateRetVoid();
+        }
+        else
+        {
+            builder.CreateRet(call);
+        }
+    }
+    return redefined;
+}
+
+std::string ReplSession::formatValue(const Type* type, const void* value)
+{
+    const auto quote = [](const std::string& str) {
+        return fmt::format("\"{}\"", str);
+    };
+
+    switch(type->kind.get())
+    {
+    case Type::INT8:
+        return std::to_string(*static_cast<const int8_t*>(value));
+    case Type::INT16:
+        return std::to_string(*static_cast<const int16_t*>(value));
+    case Type::INT32:
+        return std::to_string(*static_cast<const int32_t*>(value));
+    case Type::INT64:
+        return std::to_string(*static_cast<const int64_t*>(value));
+    case Type::BOOL:
+        return (*static_cast<const uint8_t*>(value) & 1) != 0 ? "true"
+                                                                : "false";
+    case Type::F32:
+        return fmt::format("{}", *static_cast<const float*>(value));
+    case Type::F64:
+        return fmt::format("{}", *static_cast<const double*>(value));
+    case Type::BYTE:
+        return std::to_string(*static_cast<const uint8_t*>(value));
+    case Type::CHAR:
+    {
+        std::string str;
+        utf8::append(*static_cast<const char32_t*>(value),
+                     std::back_inserter(str));
+        return fmt::format("'{}'", str);
+    }
+    case Type::BCHAR:
+        return fmt::format("'{}'", *static_cast<const char*>(value));
+    case Type::STRING:
+    {
+        // {i64 length, i8* data}
+        struct String
+        {
+            int64_t length;
+            const char* data;
+        };
+        const auto str = static_cast<const String*>(value);
+        return quote(std::string(str->data, static_cast<size_t>(str->length)));
+    }
+    case Type::CSTRING:
+        return quote(*static_cast<const char* const*>(value));
+    default:
+        return fmt::format("<{}>", type->getName());
+    }
+}
+} // namespace codegen
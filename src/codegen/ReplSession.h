@@ -0,0 +1,91 @@
+// Copyright (C) 2016-2017 Elias Kosunen
+// This file is distributed under the 3-Clause BSD License
+// See LICENSE for details
+
+#pragma once
+
+#include "ast/AST.h"
+#include "codegen/CodegenInfo.h"
+#include "codegen/CodegenVisitor.h"
+#include "codegen/JIT.h"
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace codegen
+{
+/**
+ * Interactive compilation session (`varuna -repl`).
+ * Every input is parsed, compiled into a new module and added to the JIT.
+ * The symbol table is kept between inputs.
+ *
+ * Functions are called through a stub, that jumps through a pointer to
+ * the latest definition. Redefining a function only compiles the new
+ * definition, and points the stub to it.
+ */
+class ReplSession final
+{
+public:
+    /**
+     * \param pOptLevel  Optimization level
+     * \param pSizeLevel Size optimization level
+     */
+    ReplSession(uint8_t pOptLevel, uint8_t pSizeLevel);
+
+    ReplSession(const ReplSession&) = delete;
+    ReplSession(ReplSession&&) noexcept = delete;
+    ReplSession& operator=(const ReplSession&) = delete;
+    ReplSession& operator=(ReplSession&&) noexcept = delete;
+    ~ReplSession() noexcept;
+
+    /**
+     * Evaluate an input: a top-level item, or an expression.
+     * Expressions are run immediately.
+     * \param  input Source code
+     * \return       Success
+     */
+    bool eval(const std::string& input);
+
+    /// Get the value of the last evaluated expression as `<value>: <type>`.
+    /// Empty if the input wasn't an expression, or had no value
+    const std::string& getResult() const
+    {
+        return result;
+    }
+
+private:
+    /**
+     * Rename the functions defined in a module to `<name>.<version>`.
+     * The first definition of a function also gets the stub `<name>`,
+     * calling through the pointer `<name>.ptr`.
+     * `versions` isn't updated, since the module may still be rejected
+     * \param  m     Module
+     * \param  names Names of the defined functions are appended to this
+     * \return       Pointers to update, and the redefinitions
+     * they should point to
+     */
+    std::vector<std::pair<std::string, std::string>>
+    makeSwappable(llvm::Module& m, std::vector<std::string>& names);
+
+    /// Format the value of an expression
+    static std::string formatValue(const Type* type, const void* value);
+
+    CodegenInfo info;
+    llvm::LLVMContext context;
+    /// Module CodegenVisitor is created with, nothing is generated into it
+    std::unique_ptr<llvm::Module> base;
+    std::unique_ptr<CodegenVisitor> codegen;
+    std::unique_ptr<JIT> jit;
+    /// ASTs of the inputs, symbols refer to their nodes
+    std::vector<std::shared_ptr<ast::AST>> asts;
+    /// Number of definitions of every function
+    std::unordered_map<std::string, uint32_t> versions;
+    /// Number of inputs
+    size_t count{0};
+    std::string result;
+};
+} // namespace codegen
@@ -8,6 +8,7 @@
 #include "codegen/Type.h"
 #include "codegen/TypedValue.h"
 #include "util/SourceLocation.h"
+#include <array>
 
 namespace codegen
 {
@@ -34,6 +35,7 @@ public:
     {
         auto s = std::make_unique<Symbol>(loc, value->clone(), name, isMutable);
         s->isExport = isExport;
+        s->isLazy = isLazy;
         return s;
     }
 
@@ -64,6 +66,10 @@ public:
     bool isExport{false};
     /// Is mutable
     bool isMutable{false};
+    /// Imported symbol, or a symbol defined by an earlier input of an
+    /// interactive session, that hasn't been declared in the LLVM module yet.
+    /// value->value is nullptr until CodegenVisitor declares it on first use
+    bool isLazy{false};
     /// Defined in
     util::SourceLocation loc;
 
@@ -79,6 +85,27 @@ protected:
 class FunctionSymbol : public Symbol
 {
 public:
+    /// Function attributes, e.g. `@inline`
+    enum Attribute : uint32_t
+    {
+        ATTR_INLINE = 1 << 0,
+        ATTR_NOINLINE = 1 << 1,
+        ATTR_HOT = 1 << 2,
+        ATTR_COLD = 1 << 3,
+        ATTR_PURE = 1 << 4,
+        ATTR_CONST = 1 << 5,
+        ATTR_FASTMATH = 1 << 6
+    };
+
+    /// Attribute names, in the order of their bits
+    static const std::array<const char*, 7>& getAttributeNames()
+    {
+        static const std::array<const char*, 7> names{{"inline", "noinline",
+                                                       "hot", "cold", "pure",
+                                                       "const", "fastmath"}};
+        return names;
+    }
+
     FunctionSymbol(util::SourceLocation l, std::unique_ptr<TypedValue> pValue,
                    std::string pName, ast::FunctionPrototypeStmt* pProto)
         : Symbol(std::move(l), std::move(pValue), std::move(pName), false),
@@ -91,7 +118,9 @@ public:
         auto s =
             std::make_unique<FunctionSymbol>(loc, value->clone(), name, proto);
         s->isExport = isExport;
+        s->isLazy = isLazy;
         s->mangled = mangled;
+        s->attributes = attributes;
         return std::move(s);
     }
 
@@ -104,5 +133,7 @@ public:
     ast::FunctionPrototypeStmt* proto;
     /// Is name mangled
     bool mangled{true};
+    /// Attributes, bitmask of Attribute
+    uint32_t attributes{0};
 };
 } // namespace codegen
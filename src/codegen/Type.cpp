@@ -380,15 +380,7 @@ bool StringType::isFloatingPoint() const
 std::unique_ptr<TypedValue> StringType::zeroInit()
 {
     auto stringLen = llvm::ConstantInt::get(llvm::Type::getInt64Ty(context), 0);
-    auto stringConst = llvm::ConstantDataArray::getString(context, "", false);
-    auto stringGlobal = new llvm::GlobalVariable(
-        *typeTable->getModule(), stringConst->getType(), true,
-        llvm::GlobalValue::InternalLinkage, stringConst, ".str");
-    auto indexConst =
-        llvm::ConstantInt::get(llvm::Type::getInt32Ty(context), 0);
-    std::vector<llvm::Constant*> indexList = {indexConst, indexConst};
-    auto stringPtr = llvm::ConstantExpr::getGetElementPtr(
-        stringConst->getType(), stringGlobal, indexList, true);
+    auto stringPtr = typeTable->getStringConstant("");
 
     auto val = llvm::ConstantStruct::get(llvm::cast<llvm::StructType>(type),
                                          {stringLen, stringPtr});
@@ -428,17 +420,7 @@ bool CStringType::isFloatingPoint() const
 
 std::unique_ptr<TypedValue> CStringType::zeroInit()
 {
-    auto stringConst = llvm::ConstantDataArray::getString(context, "", true);
-    auto stringGlobal = new llvm::GlobalVariable(
-        *typeTable->getModule(), stringConst->getType(), true,
-        llvm::GlobalValue::InternalLinkage, stringConst, ".str");
-    auto indexConst =
-        llvm::ConstantInt::get(llvm::Type::getInt32Ty(context), 0);
-    std::vector<llvm::Constant*> indexList = {indexConst, indexConst};
-    auto stringPtr = llvm::ConstantExpr::getGetElementPtr(
-        stringConst->getType(), stringGlobal, indexList, true);
-
-    auto val = stringPtr;
+    auto val = typeTable->getStringConstant("");
 
     /*auto val = llvm::ConstantStruct::get(
         llvm::cast<llvm::StructType>(type),
@@ -552,6 +534,147 @@ llvm::DISubroutineType* FunctionType::createDebugFunctionType(
         dbuilder->getOrCreateTypeArray(elementTypes));
 }
 
+ArrayType::ArrayType(TypeTable* list, llvm::LLVMContext& c,
+                     llvm::DIBuilder& dbuilder, Type* pElementType,
+                     uint64_t pLength)
+    : Type(list, std::make_unique<ArrayTypeOperation>(this), ARRAY, c,
+           llvm::ArrayType::get(pElementType->type, pLength), nullptr,
+           arrayTypeToString(pElementType, pLength)),
+      elementType(pElementType), length(pLength)
+{
+    if(elementType->dtype)
+    {
+        auto subscripts = dbuilder.getOrCreateArray(
+            {dbuilder.getOrCreateSubrange(0, static_cast<int64_t>(length))});
+        dtype = dbuilder.createArrayType(
+            elementType->dtype->getSizeInBits() * length, 0,
+            elementType->dtype, subscripts);
+    }
+}
+
+std::string ArrayType::arrayTypeToString(Type* elementType, uint64_t length)
+{
+    return fmt::format("[{}; {}]", elementType->getName(), length);
+}
+
+bool ArrayType::isIntegral() const
+{
+    return false;
+}
+bool ArrayType::isFloatingPoint() const
+{
+    return false;
+}
+
+std::unique_ptr<TypedValue> ArrayType::zeroInit()
+{
+    auto val = llvm::ConstantAggregateZero::get(type);
+    return std::make_unique<TypedValue>(this, val, TypedValue::RVALUE, true);
+}
+
+std::string ArrayType::getMangleEncoding() const
+{
+#if VARUNA_WIN32
+    return fmt::format("Y0{}@{}", length, elementType->getMangleEncoding());
+#else
+    return fmt::format("A{}_{}", length, elementType->getMangleEncoding());
+#endif
+}
+
+SliceType::SliceType(TypeTable* list, llvm::LLVMContext& c,
+                     llvm::DIBuilder& /*dbuilder*/, Type* pElementType)
+    : Type(list, std::make_unique<SliceTypeOperation>(this), SLICE, c,
+           getLLVMSliceType(pElementType), nullptr,
+           sliceTypeToString(pElementType)),
+      elementType(pElementType)
+{
+}
+
+llvm::StructType* SliceType::getLLVMSliceType(Type* elementType)
+{
+    auto& c = elementType->context;
+    return llvm::StructType::get(
+        c, {elementType->type->getPointerTo(), llvm::Type::getInt64Ty(c)});
+}
+
+std::string SliceType::sliceTypeToString(Type* elementType)
+{
+    return fmt::format("[{}]", elementType->getName());
+}
+
+bool SliceType::isIntegral() const
+{
+    return false;
+}
+bool SliceType::isFloatingPoint() const
+{
+    return false;
+}
+
+std::unique_ptr<TypedValue> SliceType::zeroInit()
+{
+    // Null pointer, zero length
+    auto val = llvm::ConstantAggregateZero::get(type);
+    return std::make_unique<TypedValue>(this, val, TypedValue::RVALUE, true);
+}
+
+std::string SliceType::getMangleEncoding() const
+{
+#if VARUNA_WIN32
+    return fmt::format("Uslice@@{}", elementType->getMangleEncoding());
+#else
+    return fmt::format("5sliceI{}E", elementType->getMangleEncoding());
+#endif
+}
+
+VectorType::VectorType(TypeTable* list, llvm::LLVMContext& c,
+                       llvm::DIBuilder& dbuilder, Type* pElementType,
+                       unsigned pWidth)
+    : Type(list, std::make_unique<VectorTypeOperation>(this), VECTOR, c,
+           llvm::VectorType::get(pElementType->type, pWidth), nullptr,
+           vectorTypeToString(pElementType, pWidth)),
+      elementType(pElementType), width(pWidth)
+{
+    assert(elementType->isIntegral() || elementType->isFloatingPoint());
+    if(elementType->dtype)
+    {
+        const auto size = elementType->dtype->getSizeInBits() * width;
+        auto subscripts = dbuilder.getOrCreateArray(
+            {dbuilder.getOrCreateSubrange(0, width)});
+        dtype = dbuilder.createVectorType(size, static_cast<uint32_t>(size),
+                                          elementType->dtype, subscripts);
+    }
+}
+
+std::string VectorType::vectorTypeToString(Type* elementType, unsigned width)
+{
+    return fmt::format("{}x{}", elementType->getName(), width);
+}
+
+bool VectorType::isIntegral() const
+{
+    return false;
+}
+bool VectorType::isFloatingPoint() const
+{
+    return false;
+}
+
+std::unique_ptr<TypedValue> VectorType::zeroInit()
+{
+    auto val = llvm::ConstantAggregateZero::get(type);
+    return std::make_unique<TypedValue>(this, val, TypedValue::RVALUE, true);
+}
+
+std::string VectorType::getMangleEncoding() const
+{
+#if VARUNA_WIN32
+    return fmt::format("U{}@@", getName());
+#else
+    return fmt::format("Dv{}_{}", width, elementType->getMangleEncoding());
+#endif
+}
+
 AliasType::AliasType(TypeTable* list, llvm::LLVMContext& c,
                      llvm::DIBuilder& /*dbuilder*/,
                      const std::string& pAliasName, Type* pUnderlying)
@@ -43,7 +43,10 @@ public:
         BCHAR,
         STRING,
         CSTRING,
-        FUNCTION
+        FUNCTION,
+        ARRAY,
+        SLICE,
+        VECTOR
     };
     enum CastType
     {
@@ -424,6 +427,76 @@ public:
     std::vector<Type*> params;
 };
 
+class ArrayType : public Type
+{
+public:
+    ArrayType(TypeTable* list, llvm::LLVMContext& c, llvm::DIBuilder& dbuilder,
+              Type* pElementType, uint64_t pLength);
+
+    /// Get the name of an array type, e.g. `[i32; 4]`
+    static std::string arrayTypeToString(Type* elementType, uint64_t length);
+
+    std::unique_ptr<TypedValue> cast(ast::Node* node,
+                                     llvm::IRBuilder<>& builder, CastType c,
+                                     TypedValue* val, Type* to) const override;
+
+    std::unique_ptr<TypedValue> zeroInit() override;
+
+    bool isIntegral() const override;
+    bool isFloatingPoint() const override;
+    std::string getMangleEncoding() const override;
+
+    Type* elementType;
+    uint64_t length;
+};
+
+class SliceType : public Type
+{
+public:
+    SliceType(TypeTable* list, llvm::LLVMContext& c, llvm::DIBuilder& dbuilder,
+              Type* pElementType);
+
+    /// {T* data, i64 length}
+    static llvm::StructType* getLLVMSliceType(Type* elementType);
+    /// Get the name of a slice type, e.g. `[i32]`
+    static std::string sliceTypeToString(Type* elementType);
+
+    std::unique_ptr<TypedValue> cast(ast::Node* node,
+                                     llvm::IRBuilder<>& builder, CastType c,
+                                     TypedValue* val, Type* to) const override;
+
+    std::unique_ptr<TypedValue> zeroInit() override;
+
+    bool isIntegral() const override;
+    bool isFloatingPoint() const override;
+    std::string getMangleEncoding() const override;
+
+    Type* elementType;
+};
+
+class VectorType : public Type
+{
+public:
+    VectorType(TypeTable* list, llvm::LLVMContext& c, llvm::DIBuilder& dbuilder,
+               Type* pElementType, unsigned pWidth);
+
+    /// Get the name of a vector type, e.g. `f32x4`
+    static std::string vectorTypeToString(Type* elementType, unsigned width);
+
+    std::unique_ptr<TypedValue> cast(ast::Node* node,
+                                     llvm::IRBuilder<>& builder, CastType c,
+                                     TypedValue* val, Type* to) const override;
+
+    std::unique_ptr<TypedValue> zeroInit() override;
+
+    bool isIntegral() const override;
+    bool isFloatingPoint() const override;
+    std::string getMangleEncoding() const override;
+
+    Type* elementType;
+    unsigned width;
+};
+
 class AliasType : public Type
 {
 public:
@@ -4,6 +4,7 @@
 
 #include "ast/OperatorExpr.h"
 #include "codegen/Type.h"
+#include "codegen/TypeOperation.h"
 #include "codegen/TypeTable.h"
 #include "codegen/TypedValue.h"
 
@@ -282,6 +283,92 @@ std::unique_ptr<TypedValue> FunctionType::cast(ast::Node* node,
     return castError(node, "Invalid cast: Cannot cast function");
 }
 
+std::unique_ptr<TypedValue> ArrayType::cast(ast::Node* node,
+                                            llvm::IRBuilder<>& builder,
+                                            CastType c, TypedValue* val,
+                                            Type* to) const
+{
+    if(c == IMPLICIT)
+    {
+        return implicitCast(node, builder, val, to);
+    }
+
+    // An array can be viewed as a slice with the same element type
+    auto slice = dynamic_cast<SliceType*>(to->getOperations()->type);
+    if(c == CAST && slice && slice->elementType->equal(elementType))
+    {
+        auto ptr = ArrayTypeOperation::getPointer(builder, val);
+        auto data = builder.CreateInBoundsGEP(
+            type, ptr, {builder.getInt64(0), builder.getInt64(0)}, "datatmp");
+        llvm::Value* ret = llvm::UndefValue::get(to->type);
+        ret = builder.CreateInsertValue(ret, data, 0);
+        ret = builder.CreateInsertValue(ret, builder.getInt64(length), 1,
+                                        "slicetmp");
+        return std::make_unique<TypedValue>(to, ret, TypedValue::RVALUE,
+                                            val->isMutable);
+    }
+    return castError(node, "Invalid cast: Cannot convert from {} to {}",
+                     getName(), to->getName());
+}
+
+std::unique_ptr<TypedValue> SliceType::cast(ast::Node* node,
+                                            llvm::IRBuilder<>& builder,
+                                            CastType c, TypedValue* val,
+                                            Type* to) const
+{
+    if(c == IMPLICIT)
+    {
+        return implicitCast(node, builder, val, to);
+    }
+
+    return castError(node, "Invalid cast: Cannot cast slice");
+}
+
+std::unique_ptr<TypedValue> VectorType::cast(ast::Node* node,
+                                             llvm::IRBuilder<>& builder,
+                                             CastType c, TypedValue* val,
+                                             Type* to) const
+{
+    if(c == IMPLICIT)
+    {
+        return implicitCast(node, builder, val, to);
+    }
+
+    auto ret = [&](llvm::Value* v) {
+        return std::make_unique<TypedValue>(to, v, TypedValue::RVALUE,
+                                            val->isMutable);
+    };
+
+    auto vector = dynamic_cast<VectorType*>(to->getOperations()->type);
+    if(c == BITCAST && vector &&
+       type->getPrimitiveSizeInBits() == to->type->getPrimitiveSizeInBits())
+    {
+        return ret(builder.CreateBitCast(val->value, to->type, "casttmp"));
+    }
+    if(c != CAST || !vector || vector->width != width)
+    {
+        return castError(node, "Invalid cast: Cannot convert from {} to {}",
+                         getName(), to->getName());
+    }
+
+    // Element-wise conversion
+    const bool fromFP = elementType->isFloatingPoint();
+    const bool toFP = vector->elementType->isFloatingPoint();
+    if(fromFP && toFP)
+    {
+        return ret(builder.CreateFPCast(val->value, to->type, "casttmp"));
+    }
+    if(fromFP)
+    {
+        return ret(builder.CreateFPToSI(val->value, to->type, "casttmp"));
+    }
+    if(toFP)
+    {
+        return ret(builder.CreateSIToFP(val->value, to->type, "casttmp"));
+    }
+    return ret(builder.CreateIntCast(val->value, to->type, true, "casttmp"));
+}
+
 std::unique_ptr<TypedValue> AliasType::cast(ast::Node* node,
                                             llvm::IRBuilder<>& builder,
                                             CastType c, TypedValue* val,
@@ -8,9 +8,201 @@
 #include "codegen/Type.h"
 #include "codegen/TypeTable.h"
 #include "codegen/TypedValue.h"
+#include "util/ProgramOptions.h"
+#include <llvm/IR/Intrinsics.h>
 
 namespace codegen
 {
+namespace
+{
+/**
+ * Convert the index of a subscript to i64, and check it against the length.
+ *
+ * Constant indices of constant-length arrays are checked when compiling.
+ * Other indices are checked at runtime with a single unsigned comparison,
+ * which catches negative indices too.
+ * Out-of-bounds accesses trap. The trapping branch ends in `unreachable`,
+ * so it's considered cold, and the optimizer can remove the check
+ * when the index is an induction variable known to be less than the length.
+ * Runtime checks are disabled with `-fno-bounds-check`.
+ *
+ * \param  node    Subscript expression
+ * \param  builder LLVM IRBuilder
+ * \param  index   Index operand
+ * \param  length  Length of the array or the slice, i64
+ * \param  count   Number of consecutive elements accessed
+ * \return         Index as i64, nullptr on error
+ */
+llvm::Value* checkIndex(ast::Node* node, llvm::IRBuilder<>& builder,
+                        TypedValue* index, llvm::Value* length,
+                        uint64_t count = 1)
+{
+    if(!index->type->isIntegral())
+    {
+        return util::logCompilerError(node->loc,
+                                      "Invalid subscript: Index has to be "
+                                      "of integral type, got '{}' instead",
+                                      index->type->getName());
+    }
+    auto idx =
+        builder.CreateSExtOrTrunc(index->value, builder.getInt64Ty(), "idxtmp");
+
+    // Constant indices are checked at compile time,
+    // even without bounds checks and in global initializers
+    auto constIdx = llvm::dyn_cast<llvm::ConstantInt>(idx);
+    auto constLen = llvm::dyn_cast<llvm::ConstantInt>(length);
+    if(constIdx && constLen)
+    {
+        // Unsigned, so that negative indices are out of bounds too
+        const auto i = constIdx->getZExtValue();
+        const auto len = constLen->getZExtValue();
+        if(i >= len || count > len - i)
+        {
+            return util::logCompilerError(
+                node->loc, "Invalid subscript: Index {} is out of bounds",
+                constIdx->getSExtValue());
+        }
+        return idx;
+    }
+
+    if(!util::ProgramOptions::view().boundsCheck || !builder.GetInsertBlock())
+    {
+        return idx;
+    }
+
+    auto inBounds = builder.CreateICmpULT(idx, length, "boundstmp");
+    if(count > 1)
+    {
+        // The last element has to be in bounds too.
+        // It can't overflow, since the first one is less than the length
+        auto last =
+            builder.CreateAdd(idx, builder.getInt64(count - 1), "lasttmp");
+        inBounds = builder.CreateAnd(
+            inBounds, builder.CreateICmpULT(last, length), "boundstmp");
+    }
+    auto func = builder.GetInsertBlock()->getParent();
+    auto failBB =
+        llvm::BasicBlock::Create(builder.getContext(), "bounds.fail", func);
+    auto okBB =
+        llvm::BasicBlock::Create(builder.getContext(), "bounds.ok", func);
+    builder.CreateCondBr(inBounds, okBB, failBB);
+
+    builder.SetInsertPoint(failBB);
+    builder.CreateCall(llvm::Intrinsic::getDeclaration(func->getParent(),
+                                                       llvm::Intrinsic::trap));
+    builder.CreateUnreachable();
+
+    builder.SetInsertPoint(okBB);
+    return idx;
+}
+/**
+ * Create a signed integer addition, subtraction or multiplication,
+ * with the overflow behavior selected with -fwrapv or -ftrapv.
+ * By default, overflow is undefined (nsw).
+ * With -ftrapv, vector operations wrap around,
+ * since there are no overflow-checking intrinsics for them
+ * \param  node   Node of the operation, for error messages
+ * \param  opcode Add, Sub or Mul
+ * \return        Result, nullptr on error
+ */
+llvm::Value* createSignedArithmetic(ast::Node* node,
+                                    llvm::IRBuilder<>& builder,
+                                    llvm::Instruction::BinaryOps opcode,
+                                    llvm::Value* lhs, llvm::Value* rhs,
+                                    const llvm::Twine& name)
+{
+    assert(opcode == llvm::Instruction::Add ||
+           opcode == llvm::Instruction::Sub ||
+           opcode == llvm::Instruction::Mul);
+
+    const auto policy = util::ProgramOptions::view().overflow;
+    if(policy == util::OVERFLOW_UNDEFINED)
+    {
+        switch(opcode)
+        {
+        case llvm::Instruction::Add:
+            return builder.CreateNSWAdd(lhs, rhs, name);
+        case llvm::Instruction::Sub:
+            return builder.CreateNSWSub(lhs, rhs, name);
+        default:
+            return builder.CreateNSWMul(lhs, rhs, name);
+        }
+    }
+    if(policy == util::OVERFLOW_WRAP || lhs->getType()->isVectorTy())
+    {
+        return builder.CreateBinOp(opcode, lhs, rhs, name);
+    }
+
+    auto l = llvm::dyn_cast<llvm::ConstantInt>(lhs);
+    auto r = llvm::dyn_cast<llvm::ConstantInt>(rhs);
+    if(l && r)
+    {
+        bool overflow = false;
+        auto result = [&]() {
+            switch(opcode)
+            {
+            case llvm::Instruction::Add:
+                return l->getValue().sadd_ov(r->getValue(), overflow);
+            case llvm::Instruction::Sub:
+                return l->getValue().ssub_ov(r->getValue(), overflow);
+            default:
+                return l->getValue().smul_ov(r->getValue(), overflow);
+            }
+        }();
+        if(overflow)
+        {
+            return util::logCompilerError(
+                node->loc, "Signed integer overflow in constant expression");
+        }
+        return builder.getInt(result);
+    }
+    if(!builder.GetInsertBlock())
+    {
+        return builder.CreateBinOp(opcode, lhs, rhs, name);
+    }
+
+    const auto id = [&]() {
+        switch(opcode)
+        {
+        case llvm::Instruction::Add:
+            return llvm::Intrinsic::sadd_with_overflow;
+        case llvm::Instruction::Sub:
+            return llvm::Intrinsic::ssub_with_overflow;
+        default:
+            return llvm::Intrinsic::smul_with_overflow;
+        }
+    }();
+    auto func = builder.GetInsertBlock()->getParent();
+    auto call = builder.CreateCall(
+        llvm::Intrinsic::getDeclaration(func->getParent(), id,
+                                        lhs->getType()),
+        {lhs, rhs}, name);
+    auto overflow = builder.CreateExtractValue(call, 1, "overflowtmp");
+
+    auto failBB =
+        llvm::BasicBlock::Create(builder.getContext(), "overflow.fail", func);
+    auto okBB =
+        llvm::BasicBlock::Create(builder.getContext(), "overflow.ok", func);
+    builder.CreateCondBr(overflow, failBB, okBB);
+
+    builder.SetInsertPoint(failBB);
+    builder.CreateCall(llvm::Intrinsic::getDeclaration(func->getParent(),
+                                                       llvm::Intrinsic::trap));
+    builder.CreateUnreachable();
+
+    builder.SetInsertPoint(okBB);
+    return builder.CreateExtractValue(call, 0, name);
+}
+} // namespace
+
+std::unique_ptr<TypedValue> TypeOperationBase::memberCall(
+    ast::Node* node, llvm::IRBuilder<>& /*builder*/, TypedValue* /*object*/,
+    const std::string& member, std::vector<TypedValue*> /*args*/) const
+{
+    return operationError(node, "'{}' has no member function '{}'",
+                          type->getName(), member);
+}
+
 std::unique_ptr<TypedValue> VoidTypeOperation::assignmentOperation(
     ast::Node* node, llvm::IRBuilder<>& /*builder*/, util::OperatorType /*op*/,
     std::vector<TypedValue*> /*operands*/) const
@@ -138,7 +330,17 @@ std::unique_ptr<TypedValue> IntegralTypeOperation::unaryOperation(
                                        t);
     }
     case util::OPERATORU_MINUS:
-        return ret(builder.CreateNeg(operands[0]->value, "negtmp"));
+    {
+        auto v = createSignedArithmetic(
+            node, builder, llvm::Instruction::Sub,
+            llvm::ConstantInt::get(operands[0]->value->getType(), 0),
+            operands[0]->value, "negtmp");
+        if(!v)
+        {
+            return nullptr;
+        }
+        return ret(v);
+    }
     case util::OPERATORU_NOT:
         return ret(builder.CreateXor(operands[0]->value,
                                      static_cast<uint64_t>(-1), "compltmp"));
@@ -172,17 +374,25 @@ std::unique_ptr<TypedValue> IntegralTypeOperation::binaryOperation(
         return std::make_unique<TypedValue>(boolt, v, TypedValue::RVALUE,
                                             operands[0]->isMutable);
     };
+    auto arith = [&](llvm::Instruction::BinaryOps opcode,
+                     const llvm::Twine& name) -> std::unique_ptr<TypedValue> {
+        auto v = createSignedArithmetic(node, builder, opcode,
+                                        operands[0]->value,
+                                        operands[1]->value, name);
+        if(!v)
+        {
+            return nullptr;
+        }
+        return ret(v);
+    };
     switch(op.get())
     {
     case util::OPERATORB_ADD:
-        return ret(builder.CreateNSWAdd(operands[0]->value, operands[1]->value,
-                                        "addtmp"));
+        return arith(llvm::Instruction::Add, "addtmp");
     case util::OPERATORB_SUB:
-        return ret(builder.CreateNSWSub(operands[0]->value, operands[1]->value,
-                                        "subtmp"));
+        return arith(llvm::Instruction::Sub, "subtmp");
     case util::OPERATORB_MUL:
-        return ret(builder.CreateNSWMul(operands[0]->value, operands[1]->value,
-                                        "multmp"));
+        return arith(llvm::Instruction::Mul, "multmp");
     case util::OPERATORB_DIV:
         return ret(builder.CreateSDiv(operands[0]->value, operands[1]->value,
                                       "divtmp"));
@@ -873,4 +1083,649 @@ std::unique_ptr<TypedValue> FunctionTypeOperation::arbitraryOperation(
     return std::make_unique<TypedValue>(retType, call, TypedValue::RVALUE,
                                         false);
 }
+
+std::unique_ptr<TypedValue> ArrayTypeOperation::assignmentOperation(
+    ast::Node* node, llvm::IRBuilder<>& builder, util::OperatorType op,
+    std::vector<TypedValue*> operands) const
+{
+    assert(operands.size() == 2);
+
+    assert(operands[0]->cat != TypedValue::STMTVALUE);
+    if(operands[0]->cat == TypedValue::RVALUE)
+    {
+        return operationError(node, "Cannot assign to an rvalue");
+    }
+    if(!operands[0]->isMutable)
+    {
+        return operationError(node, "Cannot assign to immutable lhs");
+    }
+
+    auto lhs = operands[0];
+    auto rhs = operands[1];
+    if(op != util::OPERATORA_SIMPLE)
+    {
+        return operationError(node,
+                              "Unsupported assignment operator for '{}': {}",
+                              lhs->type->getName(), op.get());
+    }
+    if(rhs->type->inequal(lhs->type))
+    {
+        return operationError(node, "Cannot assign '{}' to '{}'",
+                              rhs->type->getName(), lhs->type->getName());
+    }
+
+    auto lhsload = llvm::cast<llvm::LoadInst>(lhs->value);
+    builder.CreateStore(rhs->value, lhsload->getPointerOperand());
+    return std::make_unique<TypedValue>(*lhs);
+}
+std::unique_ptr<TypedValue> ArrayTypeOperation::unaryOperation(
+    ast::Node* node, llvm::IRBuilder<>& /*builder*/, util::OperatorType /*op*/,
+    std::vector<TypedValue*> operands) const
+{
+    assert(operands.size() == 1);
+    return operationError(node, "No unary operations for '{}' are supported",
+                          operands[0]->type->getName());
+}
+std::unique_ptr<TypedValue> ArrayTypeOperation::binaryOperation(
+    ast::Node* node, llvm::IRBuilder<>& builder, util::OperatorType op,
+    std::vector<TypedValue*> operands) const
+{
+    assert(operands.size() == 2);
+
+    if(op != util::OPERATORB_SUBSCR)
+    {
+        return operationError(node, "Unsupported binary operator for '{}': {}",
+                              operands[0]->type->getName(), op.get());
+    }
+
+    auto arrayType = dynamic_cast<ArrayType*>(type);
+    assert(arrayType);
+    auto ptr = getPointer(builder, operands[0]);
+    auto index = checkIndex(node, builder, operands[1],
+                            builder.getInt64(arrayType->length));
+    if(!index)
+    {
+        return nullptr;
+    }
+
+    auto elementPtr = builder.CreateInBoundsGEP(
+        arrayType->type, ptr, {builder.getInt64(0), index}, "elemptr");
+    return std::make_unique<TypedValue>(
+        arrayType->elementType, builder.CreateLoad(elementPtr, "elemtmp"),
+        TypedValue::LVALUE, operands[0]->isMutable);
+}
+std::unique_ptr<TypedValue> ArrayTypeOperation::arbitraryOperation(
+    ast::Node* node, llvm::IRBuilder<>& /*builder*/, util::OperatorType /*op*/,
+    std::vector<TypedValue*> operands) const
+{
+    assert(!operands.empty());
+    return operationError(
+        node, "No arbitrary-operand operations for '{}' are supported",
+        operands[0]->type->getName());
+}
+
+llvm::Value* ArrayTypeOperation::getPointer(llvm::IRBuilder<>& builder,
+                                            TypedValue* val)
+{
+    if(auto load = llvm::dyn_cast<llvm::LoadInst>(val->value))
+    {
+        auto ptr = load->getPointerOperand();
+        // Loading the whole array isn't necessary for accessing an element
+        if(load->use_empty())
+        {
+            load->eraseFromParent();
+            val->value = nullptr;
+        }
+        return ptr;
+    }
+
+    auto func = builder.GetInsertBlock()->getParent();
+    llvm::IRBuilder<> entry(&func->getEntryBlock(),
+                            func->getEntryBlock().begin());
+    auto tmp = entry.CreateAlloca(val->type->type, nullptr, "arraytmp");
+    builder.CreateStore(val->value, tmp);
+    return tmp;
+}
+
+std::unique_ptr<TypedValue> SliceTypeOperation::assignmentOperation(
+    ast::Node* node, llvm::IRBuilder<>& builder, util::OperatorType op,
+    std::vector<TypedValue*> operands) const
+{
+    assert(operands.size() == 2);
+
+    assert(operands[0]->cat != TypedValue::STMTVALUE);
+    if(operands[0]->cat == TypedValue::RVALUE)
+    {
+        return operationError(node, "Cannot assign to an rvalue");
+    }
+    if(!operands[0]->isMutable)
+    {
+        return operationError(node, "Cannot assign to immutable lhs");
+    }
+
+    auto lhs = operands[0];
+    auto rhs = operands[1];
+    if(op != util::OPERATORA_SIMPLE)
+    {
+        return operationError(node,
+                              "Unsupported assignment operator for '{}': {}",
+                              lhs->type->getName(), op.get());
+    }
+    if(rhs->type->inequal(lhs->type))
+    {
+        return operationError(node, "Cannot assign '{}' to '{}'",
+                              rhs->type->getName(), lhs->type->getName());
+    }
+
+    auto lhsload = llvm::cast<llvm::LoadInst>(lhs->value);
+    builder.CreateStore(rhs->value, lhsload->getPointerOperand());
+    return std::make_unique<TypedValue>(*lhs);
+}
+std::unique_ptr<TypedValue> SliceTypeOperation::unaryOperation(
+    ast::Node* node, llvm::IRBuilder<>& /*builder*/, util::OperatorType /*op*/,
+    std::vector<TypedValue*> operands) const
+{
+    assert(operands.size() == 1);
+    return operationError(node, "No unary operations for '{}' are supported",
+                          operands[0]->type->getName());
+}
+std::unique_ptr<TypedValue> SliceTypeOperation::binaryOperation(
+    ast::Node* node, llvm::IRBuilder<>& builder, util::OperatorType op,
+    std::vector<TypedValue*> operands) const
+{
+    assert(operands.size() == 2);
+
+    if(op != util::OPERATORB_SUBSCR)
+    {
+        return operationError(node, "Unsupported binary operator for '{}': {}",
+                              operands[0]->type->getName(), op.get());
+    }
+
+    auto sliceType = dynamic_cast<SliceType*>(type);
+    assert(sliceType);
+    auto slice = operands[0]->value;
+    auto index = checkIndex(node, builder, operands[1],
+                            builder.CreateExtractValue(slice, 1, "lentmp"));
+    if(!index)
+    {
+        return nullptr;
+    }
+
+    auto elementPtr = builder.CreateInBoundsGEP(
+        sliceType->elementType->type,
+        builder.CreateExtractValue(slice, 0, "datatmp"), index, "elemptr");
+    return std::make_unique<TypedValue>(
+        sliceType->elementType, builder.CreateLoad(elementPtr, "elemtmp"),
+        TypedValue::LVALUE, operands[0]->isMutable);
+}
+std::unique_ptr<TypedValue> SliceTypeOperation::arbitraryOperation(
+    ast::Node* node, llvm::IRBuilder<>& /*builder*/, util::OperatorType /*op*/,
+    std::vector<TypedValue*> operands) const
+{
+    assert(!operands.empty());
+    return operationError(
+        node, "No arbitrary-operand operations for '{}' are supported",
+        operands[0]->type->getName());
+}
+
+std::unique_ptr<TypedValue> VectorTypeOperation::assignmentOperation(
+    ast::Node* node, llvm::IRBuilder<>& builder, util::OperatorType op,
+    std::vector<TypedValue*> operands) const
+{
+    assert(operands.size() == 2);
+
+    assert(operands[0]->cat != TypedValue::STMTVALUE);
+    if(operands[0]->cat == TypedValue::RVALUE)
+    {
+        return operationError(node, "Cannot assign to an rvalue");
+    }
+    if(!operands[0]->isMutable)
+    {
+        return operationError(node, "Cannot assign to immutable lhs");
+    }
+
+    auto lhs = operands[0];
+    auto rhs = [&]() -> std::unique_ptr<TypedValue> {
+        switch(op.get())
+        {
+        case util::OPERATORA_SIMPLE:
+            return std::make_unique<TypedValue>(*operands[1]);
+        case util::OPERATORA_ADD:
+            return binaryOperation(node, builder, util::OPERATORB_ADD,
+                                   operands);
+        case util::OPERATORA_SUB:
+            return binaryOperation(node, builder, util::OPERATORB_SUB,
+                                   operands);
+        case util::OPERATORA_MUL:
+            return binaryOperation(node, builder, util::OPERATORB_MUL,
+                                   operands);
+        case util::OPERATORA_DIV:
+            return binaryOperation(node, builder, util::OPERATORB_DIV,
+                                   operands);
+        case util::OPERATORA_MOD:
+            return binaryOperation(node, builder, util::OPERATORB_MOD,
+                                   operands);
+        default:
+            return operationError(
+                node, "Unsupported assignment operator for '{}': {}",
+                lhs->type->getName(), op.get());
+        }
+    }();
+    if(!rhs)
+    {
+        return nullptr;
+    }
+    if(rhs->type->inequal(lhs->type))
+    {
+        return operationError(node, "Cannot assign '{}' to '{}'",
+                              rhs->type->getName(), lhs->type->getName());
+    }
+
+    auto lhsload = llvm::cast<llvm::LoadInst>(lhs->value);
+    builder.CreateStore(rhs->value, lhsload->getPointerOperand());
+    return std::make_unique<TypedValue>(*lhs);
+}
+std::unique_ptr<TypedValue> VectorTypeOperation::unaryOperation(
+    ast::Node* node, llvm::IRBuilder<>& builder, util::OperatorType op,
+    std::vector<TypedValue*> operands) const
+{
+    assert(operands.size() == 1);
+
+    auto vectorType = dynamic_cast<VectorType*>(type);
+    assert(vectorType);
+    if(op != util::OPERATORU_MINUS)
+    {
+        return operationError(node, "Unsupported unary operator for '{}': '{}'",
+                              operands[0]->type->getName(), op.get());
+    }
+
+    auto v = operands[0]->value;
+    return std::make_unique<TypedValue>(
+        operands[0]->type,
+        vectorType->elementType->isFloatingPoint()
+            ? builder.CreateFNeg(v, "negtmp")
+            : builder.CreateNeg(v, "negtmp"),
+        TypedValue::RVALUE, operands[0]->isMutable);
+}
+std::unique_ptr<TypedValue> VectorTypeOperation::binaryOperation(
+    ast::Node* node, llvm::IRBuilder<>& builder, util::OperatorType op,
+    std::vector<TypedValue*> operands) const
+{
+    assert(operands.size() == 2);
+
+    auto vectorType = dynamic_cast<VectorType*>(type);
+    assert(vectorType);
+
+    if(op == util::OPERATORB_SUBSCR)
+    {
+        auto index = checkIndex(node, builder, operands[1],
+                                builder.getInt64(vectorType->width));
+        if(!index)
+        {
+            return nullptr;
+        }
+        return std::make_unique<TypedValue>(
+            vectorType->elementType,
+            builder.CreateExtractElement(operands[0]->value, index,
+                                         "elemtmp"),
+            TypedValue::RVALUE, false);
+    }
+
+    if(operands[0]->type->inequal(*operands[1]->type))
+    {
+        return operationError(
+            node, "VectorType binary operation operand types "
+                  "don't match: '{}' and '{}'",
+            operands[0]->type->getName(), operands[1]->type->getName());
+    }
+
+    auto ret = [&](llvm::Value* v) {
+        return std::make_unique<TypedValue>(operands[0]->type, v,
+                                            TypedValue::RVALUE,
+                                            operands[0]->isMutable);
+    };
+    auto lhs = operands[0]->value;
+    auto rhs = operands[1]->value;
+    const bool fp = vectorType->elementType->isFloatingPoint();
+    switch(op.get())
+    {
+    case util::OPERATORB_ADD:
+        return ret(fp ? builder.CreateFAdd(lhs, rhs, "addtmp")
+                      : createSignedArithmetic(node, builder,
+                                               llvm::Instruction::Add, lhs,
+                                               rhs, "addtmp"));
+    case util::OPERATORB_SUB:
+        return ret(fp ? builder.CreateFSub(lhs, rhs, "subtmp")
+                      : createSignedArithmetic(node, builder,
+                                               llvm::Instruction::Sub, lhs,
+                                               rhs, "subtmp"));
+    case util::OPERATORB_MUL:
+        return ret(fp ? builder.CreateFMul(lhs, rhs, "multmp")
+                      : createSignedArithmetic(node, builder,
+                                               llvm::Instruction::Mul, lhs,
+                                               rhs, "multmp"));
+    case util::OPERATORB_DIV:
+        return ret(fp ? builder.CreateFDiv(lhs, rhs, "divtmp")
+                      : builder.CreateSDiv(lhs, rhs, "divtmp"));
+    case util::OPERATORB_REM:
+    case util::OPERATORB_MOD:
+        return ret(fp ? builder.CreateFRem(lhs, rhs, "remtmp")
+                      : builder.CreateSRem(lhs, rhs, "remtmp"));
+    default:
+        return operationError(node, "Unsupported binary operator for '{}': {}",
+                              operands[0]->type->getName(), op.get());
+    }
+}
+std::unique_ptr<TypedValue> VectorTypeOperation::arbitraryOperation(
+    ast::Node* node, llvm::IRBuilder<>& builder, util::OperatorType op,
+    std::vector<TypedValue*> operands) const
+{
+    auto vectorType = dynamic_cast<VectorType*>(type);
+    assert(vectorType);
+
+    if(op != util::OPERATORC_CALL)
+    {
+        return operationError(
+            node, "Unsupported arbitrary-operand operator for '{}': '{}'",
+            type->getName(), op.get());
+    }
+    if(operands.size() != 1 && operands.size() != vectorType->width)
+    {
+        return operationError(node,
+                              "Invalid construction of '{}': Expected 1 or "
+                              "{} elements, got {}",
+                              type->getName(), vectorType->width,
+                              operands.size());
+    }
+    for(const auto& o : operands)
+    {
+        if(o->type->inequal(vectorType->elementType))
+        {
+            return operationError(
+                node, "Invalid construction of '{}': Cannot convert "
+                      "element from {} to {}",
+                type->getName(), o->type->getName(),
+                vectorType->elementType->getName());
+        }
+    }
+
+    auto ret = [&](llvm::Value* v) {
+        return std::make_unique<TypedValue>(type, v, TypedValue::RVALUE,
+                                            true);
+    };
+    if(operands.size() == 1)
+    {
+        return ret(builder.CreateVectorSplat(vectorType->width,
+                                             operands[0]->value, "splattmp"));
+    }
+    llvm::Value* v = llvm::UndefValue::get(type->type);
+    for(unsigned i = 0; i < vectorType->width; ++i)
+    {
+        v = builder.CreateInsertElement(v, operands[i]->value, i, "vectmp");
+    }
+    return ret(v);
+}
+std::unique_ptr<TypedValue> VectorTypeOperation::memberCall(
+    ast::Node* node, llvm::IRBuilder<>& builder, TypedValue* object,
+    const std::string& member, std::vector<TypedValue*> args) const
+{
+    auto vectorType = dynamic_cast<VectorType*>(type);
+    assert(vectorType);
+
+    auto checkArgCount = [&](size_t count) {
+        if(args.size() != count)
+        {
+            operationError(node, "'{}.{}' expects {} arguments, {} provided",
+                           type->getName(), member, count, args.size());
+            return false;
+        }
+        return true;
+    };
+    // Alignment of the elements, not the whole vector,
+    // arrays are only aligned to that
+    const auto alignment = static_cast<unsigned>(
+        vectorType->elementType->type->getPrimitiveSizeInBits() / 8);
+
+    if(!object)
+    {
+        if(member != "load")
+        {
+            return operationError(node, "'{}' has no member function '{}'",
+                                  type->getName(), member);
+        }
+        if(!checkArgCount(2))
+        {
+            return nullptr;
+        }
+        auto ptr = getElementsPointer(node, builder, args[0], args[1]);
+        if(!ptr)
+        {
+            return nullptr;
+        }
+        return std::make_unique<TypedValue>(
+            type, builder.CreateAlignedLoad(ptr, alignment, "loadtmp"),
+            TypedValue::RVALUE, true);
+    }
+
+    if(member == "sum")
+    {
+        return checkArgCount(0)
+                   ? reduce(node, builder, object, util::OPERATORB_ADD)
+                   : nullptr;
+    }
+    if(member == "min")
+    {
+        return checkArgCount(0)
+                   ? reduce(node, builder, object, util::OPERATORB_LESS)
+                   : nullptr;
+    }
+    if(member == "max")
+    {
+        return checkArgCount(0)
+                   ? reduce(node, builder, object, util::OPERATORB_GREATER)
+                   : nullptr;
+    }
+    if(member == "insert")
+    {
+        if(!checkArgCount(2))
+        {
+            return nullptr;
+        }
+        if(args[1]->type->inequal(vectorType->elementType))
+        {
+            return operationError(node,
+                                  "Invalid insert: Cannot convert element "
+                                  "from {} to {}",
+                                  args[1]->type->getName(),
+                                  vectorType->elementType->getName());
+        }
+        auto index = checkIndex(node, builder, args[0],
+                                builder.getInt64(vectorType->width));
+        if(!index)
+        {
+            return nullptr;
+        }
+        return std::make_unique<TypedValue>(
+            object->type, builder.CreateInsertElement(
+                              object->value, args[1]->value, index, "vectmp"),
+            TypedValue::RVALUE, true);
+    }
+    if(member == "store")
+    {
+        if(!checkArgCount(2))
+        {
+            return nullptr;
+        }
+        if(!args[0]->isMutable)
+        {
+            return operationError(node, "Cannot store to immutable '{}'",
+                                  args[0]->type->getName());
+        }
+        auto ptr = getElementsPointer(node, builder, args[0], args[1]);
+        if(!ptr)
+        {
+            return nullptr;
+        }
+        auto store = builder.CreateAlignedStore(object->value, ptr, alignment);
+        return std::make_unique<TypedValue>(type->typeTable->find("void"),
+                                            store, TypedValue::RVALUE, false);
+    }
+    if(member == "shuffle")
+    {
+        // The first argument is another vector,
+        // if the elements are picked from two
+        auto second = !args.empty() && args[0]->type->equal(object->type)
+                          ? args[0]
+                          : nullptr;
+        const auto first = second ? 1u : 0u;
+        const auto sources = vectorType->width * (second ? 2 : 1);
+
+        std::vector<llvm::Constant*> mask;
+        for(auto i = first; i < args.size(); ++i)
+        {
+            auto c = llvm::dyn_cast<llvm::ConstantInt>(args[i]->value);
+            if(!args[i]->type->isIntegral() || !c)
+            {
+                return operationError(node, "Invalid shuffle: Indices have "
+                                            "to be integer constants");
+            }
+            if(c->getValue().uge(sources))
+            {
+                return operationError(
+                    node, "Invalid shuffle: Index {} is out of bounds",
+                    c->getSExtValue());
+            }
+            mask.push_back(builder.getInt32(
+                static_cast<uint32_t>(c->getZExtValue())));
+        }
+
+        // The result has as many elements as there are indices
+        auto resultName = VectorType::vectorTypeToString(
+            vectorType->elementType, static_cast<unsigned>(mask.size()));
+        auto resultType = type->typeTable->find(resultName);
+        if(!resultType || resultType->kind != Type::VECTOR)
+        {
+            return operationError(node,
+                                  "Invalid shuffle: No vector type '{}'",
+                                  resultName);
+        }
+        return std::make_unique<TypedValue>(
+            resultType,
+            builder.CreateShuffleVector(
+                object->value,
+                second ? second->value
+                       : llvm::UndefValue::get(object->value->getType()),
+                llvm::ConstantVector::get(mask), "shuffletmp"),
+            TypedValue::RVALUE, true);
+    }
+    return operationError(node, "'{}' has no member function '{}'",
+                          type->getName(), member);
+}
+
+std::unique_ptr<TypedValue>
+VectorTypeOperation::reduce(ast::Node* node, llvm::IRBuilder<>& builder,
+                            TypedValue* val, util::OperatorType op) const
+{
+    auto vectorType = dynamic_cast<VectorType*>(type);
+    assert(vectorType);
+    const bool fp = vectorType->elementType->isFloatingPoint();
+
+    auto combine = [&](llvm::Value* lhs, llvm::Value* rhs) -> llvm::Value* {
+        switch(op.get())
+        {
+        case util::OPERATORB_ADD:
+            return fp ? builder.CreateFAdd(lhs, rhs, "rdx.add")
+                      : builder.CreateAdd(lhs, rhs, "rdx.add");
+        case util::OPERATORB_LESS:
+            return builder.CreateSelect(
+                fp ? builder.CreateFCmpOLT(lhs, rhs, "rdx.cmp")
+                   : builder.CreateICmpSLT(lhs, rhs, "rdx.cmp"),
+                lhs, rhs, "rdx.min");
+        case util::OPERATORB_GREATER:
+            return builder.CreateSelect(
+                fp ? builder.CreateFCmpOGT(lhs, rhs, "rdx.cmp")
+                   : builder.CreateICmpSGT(lhs, rhs, "rdx.cmp"),
+                lhs, rhs, "rdx.max");
+        default:
+            return operationError(node, "Unsupported reduction for '{}': {}",
+                                  type->getName(), op.get());
+        }
+    };
+
+    // Halve the vector until one element is left.
+    // This is the pattern the backend recognizes as a horizontal reduction
+    auto v = val->value;
+    llvm::Constant* undef = llvm::UndefValue::get(builder.getInt32Ty());
+    for(auto n = vectorType->width / 2; n > 0; n /= 2)
+    {
+        std::vector<llvm::Constant*> mask;
+        for(unsigned i = 0; i < vectorType->width; ++i)
+        {
+            mask.push_back(i < n ? builder.getInt32(i + n) : undef);
+        }
+        auto shuffled = builder.CreateShuffleVector(
+            v, llvm::UndefValue::get(v->getType()),
+            llvm::ConstantVector::get(mask), "rdx.shuf");
+        v = combine(v, shuffled);
+        if(!v)
+        {
+            return nullptr;
+        }
+    }
+    return std::make_unique<TypedValue>(
+        vectorType->elementType, builder.CreateExtractElement(v, uint64_t{0}),
+        TypedValue::RVALUE, false);
+}
+
+llvm::Value* VectorTypeOperation::getElementsPointer(
+    ast::Node* node, llvm::IRBuilder<>& builder, TypedValue* elements,
+    TypedValue* index) const
+{
+    auto vectorType = dynamic_cast<VectorType*>(type);
+    assert(vectorType);
+
+    auto underlying = elements->type->getOperations()->type;
+    auto array = dynamic_cast<ArrayType*>(underlying);
+    auto slice = dynamic_cast<SliceType*>(underlying);
+    if(!array && !slice)
+    {
+        return operationError(node, "Expected an array or a slice, got '{}'",
+                              elements->type->getName());
+    }
+    auto elementType = array ? array->elementType : slice->elementType;
+    if(elementType->inequal(vectorType->elementType))
+    {
+        return operationError(node, "Element types of '{}' and '{}' "
+                                    "don't match",
+                              elements->type->getName(), type->getName());
+    }
+
+    llvm::Value* ptr = nullptr;
+    llvm::Value* length = nullptr;
+    if(array)
+    {
+        ptr = ArrayTypeOperation::getPointer(builder, elements);
+        length = builder.getInt64(array->length);
+    }
+    else
+    {
+        ptr = builder.CreateExtractValue(elements->value, 0, "datatmp");
+        length = builder.CreateExtractValue(elements->value, 1, "lentmp");
+    }
+    auto idx =
+        checkIndex(node, builder, index, length, vectorType->width);
+    if(!idx)
+    {
+        return nullptr;
+    }
+
+    auto elementPtr =
+        array ? builder.CreateInBoundsGEP(array->type, ptr,
+                                          {builder.getInt64(0), idx},
+                                          "elemptr")
+              : builder.CreateInBoundsGEP(elementType->type, ptr, idx,
+                                          "elemptr");
+    return builder.CreateBitCast(elementPtr, type->type->getPointerTo(),
+                                 "vecptr");
+}
 } // namespace codegen
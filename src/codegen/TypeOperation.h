@@ -68,6 +68,19 @@ public:
     arbitraryOperation(ast::Node* node, llvm::IRBuilder<>& builder,
                        util::OperatorType op,
                        std::vector<TypedValue*> operands) const = 0;
+    /**
+     * Member function calls: `object.member(args)`
+     * \param  node    Call expression
+     * \param  builder LLVM IRBuilder
+     * \param  object  Object, nullptr if called on the type itself,
+     * e.g. `f32x4.load(a, 0)`
+     * \param  member  Member function name
+     * \param  args    Arguments
+     * \return         Return value, nullptr on error
+     */
+    virtual std::unique_ptr<TypedValue>
+    memberCall(ast::Node* node, llvm::IRBuilder<>& builder, TypedValue* object,
+               const std::string& member, std::vector<TypedValue*> args) const;
 
     Type* type;
 };
@@ -299,4 +312,117 @@ public:
                        util::OperatorType op,
                        std::vector<TypedValue*> operands) const override;
 };
+
+class ArrayTypeOperation : public TypeOperationBase
+{
+public:
+    explicit ArrayTypeOperation(ArrayType* pType) : TypeOperationBase(pType)
+    {
+    }
+
+    std::unique_ptr<TypedValue>
+    assignmentOperation(ast::Node* node, llvm::IRBuilder<>& builder,
+                        util::OperatorType op,
+                        std::vector<TypedValue*> operands) const override;
+    std::unique_ptr<TypedValue>
+    unaryOperation(ast::Node* node, llvm::IRBuilder<>& builder,
+                   util::OperatorType op,
+                   std::vector<TypedValue*> operands) const override;
+    /// Subscript: `a[i]`
+    std::unique_ptr<TypedValue>
+    binaryOperation(ast::Node* node, llvm::IRBuilder<>& builder,
+                    util::OperatorType op,
+                    std::vector<TypedValue*> operands) const override;
+    std::unique_ptr<TypedValue>
+    arbitraryOperation(ast::Node* node, llvm::IRBuilder<>& builder,
+                       util::OperatorType op,
+                       std::vector<TypedValue*> operands) const override;
+
+    /**
+     * Get a pointer to the storage of an array value.
+     * Rvalues are copied to a temporary.
+     * \param  builder LLVM IRBuilder
+     * \param  val     Array value
+     * \return         Pointer to the array
+     */
+    static llvm::Value* getPointer(llvm::IRBuilder<>& builder, TypedValue* val);
+};
+
+class SliceTypeOperation : public TypeOperationBase
+{
+public:
+    explicit SliceTypeOperation(SliceType* pType) : TypeOperationBase(pType)
+    {
+    }
+
+    std::unique_ptr<TypedValue>
+    assignmentOperation(ast::Node* node, llvm::IRBuilder<>& builder,
+                        util::OperatorType op,
+                        std::vector<TypedValue*> operands) const override;
+    std::unique_ptr<TypedValue>
+    unaryOperation(ast::Node* node, llvm::IRBuilder<>& builder,
+                   util::OperatorType op,
+                   std::vector<TypedValue*> operands) const override;
+    /// Subscript: `s[i]`
+    std::unique_ptr<TypedValue>
+    binaryOperation(ast::Node* node, llvm::IRBuilder<>& builder,
+                    util::OperatorType op,
+                    std::vector<TypedValue*> operands) const override;
+    std::unique_ptr<TypedValue>
+    arbitraryOperation(ast::Node* node, llvm::IRBuilder<>& builder,
+                       util::OperatorType op,
+                       std::vector<TypedValue*> operands) const override;
+};
+
+class VectorTypeOperation : public TypeOperationBase
+{
+public:
+    explicit VectorTypeOperation(VectorType* pType) : TypeOperationBase(pType)
+    {
+    }
+
+    std::unique_ptr<TypedValue>
+    assignmentOperation(ast::Node* node, llvm::IRBuilder<>& builder,
+                        util::OperatorType op,
+                        std::vector<TypedValue*> operands) const override;
+    std::unique_ptr<TypedValue>
+    unaryOperation(ast::Node* node, llvm::IRBuilder<>& builder,
+                   util::OperatorType op,
+                   std::vector<TypedValue*> operands) const override;
+    /// Element-wise arithmetic, and element access: `v[i]`
+    std::unique_ptr<TypedValue>
+    binaryOperation(ast::Node* node, llvm::IRBuilder<>& builder,
+                    util::OperatorType op,
+                    std::vector<TypedValue*> operands) const override;
+    /// Construction: `f32x4(x)` (splat) or `f32x4(a, b, c, d)`
+    std::unique_ptr<TypedValue>
+    arbitraryOperation(ast::Node* node, llvm::IRBuilder<>& builder,
+                       util::OperatorType op,
+                       std::vector<TypedValue*> operands) const override;
+    /**
+     * `insert(i, x)`, `shuffle([other,] indices...)`,
+     * `sum()`, `min()`, `max()`, `store(a, i)`,
+     * and `load(a, i)` on the type
+     */
+    std::unique_ptr<TypedValue>
+    memberCall(ast::Node* node, llvm::IRBuilder<>& builder, TypedValue* object,
+               const std::string& member,
+               std::vector<TypedValue*> args) const override;
+
+private:
+    /// Reduce the elements of a vector to a scalar with a binary operation
+    std::unique_ptr<TypedValue> reduce(ast::Node* node,
+                                       llvm::IRBuilder<>& builder,
+                                       TypedValue* val,
+                                       util::OperatorType op) const;
+    /**
+     * Get a pointer to `width` consecutive elements of an array or a slice,
+     * starting from an index
+     * \return Pointer to the vector, nullptr on error
+     */
+    llvm::Value* getElementsPointer(ast::Node* node,
+                                    llvm::IRBuilder<>& builder,
+                                    TypedValue* elements,
+                                    TypedValue* index) const;
+};
 } // namespace codegen
@@ -7,6 +7,9 @@
 #include "codegen/Type.h"
 #include "util/Logger.h"
 #include "util/SafeEnum.h"
+#include <llvm/IR/GlobalVariable.h>
+#include <string>
+#include <unordered_map>
 
 namespace codegen
 {
@@ -57,10 +60,28 @@ public:
     {
         return module;
     }
+    void setModule(llvm::Module* m)
+    {
+        module = m;
+        strings.clear();
+    }
+
+    /**
+     * Get a pointer to a string constant in the constant pool of the module.
+     * Every distinct string is stored once, null-terminated,
+     * so that both `string` and `cstring` values can point to it.
+     * The globals are `unnamed_addr`, so they're placed in mergeable
+     * sections, and the linker can merge equal strings across objects
+     * \param  value Contents of the string
+     * \return       `i8*` to the first character
+     */
+    llvm::Constant* getStringConstant(const std::string& value);
 
 private:
     std::vector<std::unique_ptr<Type>> list;
     llvm::Module* module;
+    /// String constant pool of the module, see getStringConstant()
+    std::unordered_map<std::string, llvm::GlobalVariable*> strings;
 };
 
 template <typename T>
@@ -85,6 +106,28 @@ inline void TypeTable::insertTypeWithVariants(llvm::LLVMContext& context,
     insertType<T>(context, dbuilder);
 }
 
+inline llvm::Constant* TypeTable::getStringConstant(const std::string& value)
+{
+    assert(module);
+    auto& context = module->getContext();
+    auto& global = strings[value];
+    if(!global)
+    {
+        auto init = llvm::ConstantDataArray::getString(context, value, true);
+        global = new llvm::GlobalVariable(*module, init->getType(), true,
+                                          llvm::GlobalValue::PrivateLinkage,
+                                          init, ".str");
+        global->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
+        global->setAlignment(1);
+    }
+
+    auto indexConst =
+        llvm::ConstantInt::get(llvm::Type::getInt32Ty(context), 0);
+    std::vector<llvm::Constant*> indexList = {indexConst, indexConst};
+    return llvm::ConstantExpr::getGetElementPtr(global->getValueType(), global,
+                                                indexList, true);
+}
+
 inline size_t TypeTable::isDefined(const std::string& name,
                                    TypeTable::FindFlags flags) const
 {
@@ -243,12 +243,15 @@ namespace lexer
             {"while", TOKEN_KEYWORD_WHILE},
             {"for", TOKEN_KEYWORD_FOR},
             {"foreach", TOKEN_KEYWORD_FOREACH},
+            {"in", TOKEN_KEYWORD_IN},
             {"return", TOKEN_KEYWORD_RETURN},
+            {"become", TOKEN_KEYWORD_BECOME},
             {"cast", TOKEN_KEYWORD_CAST},
             {"use", TOKEN_KEYWORD_USE},
 
             {"let", TOKEN_KEYWORD_LET},
             {"mut", TOKEN_KEYWORD_MUT},
+            {"const", TOKEN_KEYWORD_CONST},
 
             {"true", TOKEN_LITERAL_TRUE},
             {"false", TOKEN_LITERAL_FALSE},
@@ -295,7 +298,8 @@ namespace lexer
             {"{", TOKEN_PUNCT_BRACE_OPEN},  {"}", TOKEN_PUNCT_BRACE_CLOSE},
             {"[", TOKEN_PUNCT_SQR_OPEN},    {"]", TOKEN_PUNCT_SQR_CLOSE},
             {":", TOKEN_PUNCT_COLON},       {";", TOKEN_PUNCT_SEMICOLON},
-            {",", TOKEN_PUNCT_COMMA},       {"->", TOKEN_PUNCT_ARROW}};
+            {",", TOKEN_PUNCT_COMMA},       {"->", TOKEN_PUNCT_ARROW},
+            {"@", TOKEN_PUNCT_AT}};
 
         auto find = operators.find(buf);
         if(find == operators.end())
@@ -53,6 +53,9 @@ namespace lexer
         TOKEN_KEYWORD_CAST,
         TOKEN_KEYWORD_USE,
         TOKEN_KEYWORD_NO_MANGLE,
+        TOKEN_KEYWORD_CONST,
+        TOKEN_KEYWORD_IN,
+        TOKEN_KEYWORD_BECOME,
 
         TOKEN_IDENTIFIER = 200,
 
@@ -121,6 +124,7 @@ namespace lexer
         TOKEN_PUNCT_SEMICOLON = util::PUNCT_SEMICOLON,     // ;
         TOKEN_PUNCT_COMMA = util::PUNCT_COMMA,             // ,
         TOKEN_PUNCT_ARROW = util::PUNCT_ARROW,             // ->
+        TOKEN_PUNCT_AT = util::PUNCT_AT,                   // @
 
         TOKEN_EOF = std::numeric_limits<TokenTypeUnderlying>::max()
     };
@@ -221,9 +221,22 @@ namespace parser
                 operands.push(std::move(expr));
                 continue;
             }
+            else if(it->type == TOKEN_PUNCT_SQR_OPEN &&
+                    it != beginExprIt && (it - 1)->type == TOKEN_OPERATORB_AS)
+            {
+                // Array or slice type as the target of a cast
+                auto type = parseTypename();
+                if(!type)
+                {
+                    return nullptr;
+                }
+                operands.push(std::move(type));
+                continue;
+            }
             else if(it->type == TOKEN_PUNCT_SEMICOLON ||
                     it->type == TOKEN_PUNCT_BRACE_OPEN ||
                     it->type == TOKEN_PUNCT_SQR_OPEN ||
+                    it->type == TOKEN_PUNCT_SQR_CLOSE ||
                     it->type == TOKEN_PUNCT_COMMA)
             {
                 break;
@@ -337,15 +350,12 @@ namespace parser
         {
             ++it; // Skip ':'
 
-            if(it->type != TOKEN_IDENTIFIER)
+            auto t = parseTypename();
+            if(!t)
             {
-                return parserError("Invalid variable definition: expected "
-                                   "identifier after ':', got '{}' instead",
-                                   it->value);
+                return nullptr;
             }
-
-            typen = it->value;
-            ++it; // Skip type
+            typen = std::move(t->value);
         }
 
         // Parse possible init expression
@@ -388,6 +398,87 @@ namespace parser
         return def;
     }
 
+    std::unique_ptr<IdentifierExpr> Parser::parseTypename()
+    {
+        // Type syntax:
+        // name
+        // '[' type ';' length ']' (array)
+        // '[' type ']' (slice)
+        // Arrays and slices are named by their canonical spelling,
+        // e.g. "[i32; 4]"
+
+        const auto iter = it;
+        if(it->type == TOKEN_IDENTIFIER)
+        {
+            auto name = it->value;
+            ++it; // Skip name
+            return createNode<IdentifierExpr>(iter, std::move(name));
+        }
+        if(it->type != TOKEN_PUNCT_SQR_OPEN)
+        {
+            return parserError("Invalid type: expected identifier or '[', "
+                               "got '{}' instead",
+                               it->value);
+        }
+        ++it; // Skip '['
+
+        auto element = parseTypename();
+        if(!element)
+        {
+            return nullptr;
+        }
+
+        if(it->type == TOKEN_PUNCT_SQR_CLOSE)
+        {
+            ++it; // Skip ']'
+            return createNode<IdentifierExpr>(
+                iter, fmt::format("[{}]", element->value));
+        }
+        if(it->type != TOKEN_PUNCT_SEMICOLON)
+        {
+            return parserError("Invalid array type: expected ';' or ']' "
+                               "after element type, got '{}' instead",
+                               it->value);
+        }
+        ++it; // Skip ';'
+
+        if(it->type != TOKEN_LITERAL_INTEGER ||
+           it->modifierInt.isSet(INTEGER_HEX) ||
+           it->modifierInt.isSet(INTEGER_OCT) ||
+           it->modifierInt.isSet(INTEGER_BIN))
+        {
+            return parserError("Invalid array type: expected decimal integer "
+                               "literal as length, got '{}' instead",
+                               it->value);
+        }
+        uint64_t length = 0;
+        try
+        {
+            length = std::stoull(it->value);
+        }
+        catch(const std::exception& e)
+        {
+            return parserError("Invalid array length: '{}': {}", it->value,
+                               e.what());
+        }
+        if(length == 0)
+        {
+            return parserError("Invalid array length: cannot be zero");
+        }
+        ++it; // Skip length
+
+        if(it->type != TOKEN_PUNCT_SQR_CLOSE)
+        {
+            return parserError("Invalid array type: expected ']' after "
+                               "length, got '{}' instead",
+                               it->value);
+        }
+        ++it; // Skip ']'
+
+        return createNode<IdentifierExpr>(
+            iter, fmt::format("[{}; {}]", element->value, length));
+    }
+
     std::unique_ptr<GlobalVariableDefinitionExpr>
     Parser::parseGlobalVariableDefinition()
     {
@@ -483,8 +574,14 @@ namespace parser
         }
         ++it; // Skip ']'
 
-        return createNode<BinaryExpr>(iter, std::move(lhs), std::move(subscr),
-                                      util::OPERATORB_SUBSCR);
+        auto expr = createNode<BinaryExpr>(
+            iter, std::move(lhs), std::move(subscr), util::OPERATORB_SUBSCR);
+        // Subscript of a subscript, e.g. a[i][j]
+        if(it->type == TOKEN_PUNCT_SQR_OPEN)
+        {
+            return parseSubscriptExpression(std::move(expr));
+        }
+        return expr;
     }
 
     std::unique_ptr<IntegerLiteralExpr> Parser::parseIntegerLiteralExpression()
@@ -24,10 +24,15 @@ namespace parser
             return parseIfStatement();
         case TOKEN_KEYWORD_FOR:
             return parseForStatement();
+        case TOKEN_KEYWORD_FOREACH:
+            return parseForeachStatement();
         case TOKEN_KEYWORD_WHILE:
             return parseWhileStatement();
+        case TOKEN_PUNCT_AT:
+            return parseAttributedStatement();
 
         case TOKEN_KEYWORD_RETURN:
+        case TOKEN_KEYWORD_BECOME:
             return parseReturnStatement();
 
         case TOKEN_KEYWORD_LET:
@@ -352,6 +357,106 @@ namespace parser
         return createNode<WhileStmt>(iter, std::move(cond), std::move(body));
     }
 
+    bool Parser::parseAttributes(std::vector<Attribute>& attributes)
+    {
+        // Attribute syntax:
+        // "@" identifier [ ( integer [, integer]... ) ]
+        while(it->type == TOKEN_PUNCT_AT)
+        {
+            Attribute attr;
+            attr.loc = it->loc;
+            ++it; // Skip '@'
+
+            // 'const' is a keyword, but also a function attribute
+            if(it->type != TOKEN_IDENTIFIER &&
+               it->type != TOKEN_KEYWORD_CONST)
+            {
+                parserError("Invalid attribute: expected identifier after "
+                            "'@', got '{}' instead",
+                            it->value);
+                return false;
+            }
+            attr.name = it->value;
+            ++it; // Skip identifier
+
+            if(it->type == TOKEN_PUNCT_PAREN_OPEN)
+            {
+                ++it; // Skip '('
+                while(it->type != TOKEN_EOF)
+                {
+                    if(it->type != TOKEN_LITERAL_INTEGER)
+                    {
+                        parserError("Invalid attribute: expected integer "
+                                    "literal as argument of '@{}', got '{}' "
+                                    "instead",
+                                    attr.name, it->value);
+                        return false;
+                    }
+                    auto arg = parseIntegerLiteralExpression();
+                    if(!arg)
+                    {
+                        return false;
+                    }
+                    attr.args.push_back(arg->value);
+
+                    if(it->type == TOKEN_PUNCT_PAREN_CLOSE)
+                    {
+                        break;
+                    }
+                    if(it->type != TOKEN_PUNCT_COMMA)
+                    {
+                        parserError("Invalid attribute: Expected ')' or ',' "
+                                    "in argument list, got '{}' instead",
+                                    it->value);
+                        return false;
+                    }
+                    ++it; // Skip ','
+                }
+                ++it; // Skip ')'
+            }
+
+            attributes.push_back(std::move(attr));
+        }
+        return true;
+    }
+
+    std::unique_ptr<Stmt> Parser::parseAttributedStatement()
+    {
+        const auto iter = it;
+        std::vector<Attribute> attributes;
+        if(!parseAttributes(attributes))
+        {
+            return nullptr;
+        }
+
+        auto stmt = parseStatement();
+        if(!stmt)
+        {
+            return nullptr;
+        }
+
+        // Loop hints
+        switch(stmt->nodeType.get())
+        {
+        case Node::FOR_STMT:
+            static_cast<ForStmt*>(stmt.get())->attributes =
+                std::move(attributes);
+            break;
+        case Node::FOREACH_STMT:
+            static_cast<ForeachStmt*>(stmt.get())->attributes =
+                std::move(attributes);
+            break;
+        case Node::WHILE_STMT:
+            static_cast<WhileStmt*>(stmt.get())->attributes =
+                std::move(attributes);
+            break;
+        default:
+            return parserError(iter,
+                               "Attributes are not allowed on this statement");
+        }
+        return stmt;
+    }
+
     Parser::ForCondition Parser::parseForCondition()
     {
         // Parse the condition of a for statement
@@ -471,6 +576,75 @@ namespace parser
                                    std::move(cond.cond), std::move(cond.step));
     }
 
+    std::unique_ptr<ForeachStmt> Parser::parseForeachStatement()
+    {
+        // Foreach-statement syntax
+        // "foreach" [ ( ] identifier "in" [begin ,] end [ ) ] statement
+
+        const auto iter = it;
+        ++it; // Skip 'foreach'
+
+        if(it->type == TOKEN_PUNCT_PAREN_OPEN)
+        {
+            ++it; // Skip '('
+        }
+
+        if(it->type != TOKEN_IDENTIFIER)
+        {
+            return parserError("Invalid foreach statement: expected "
+                               "identifier after 'foreach', got '{}'",
+                               it->value);
+        }
+        auto iterator = createNode<IdentifierExpr>(it, std::string(it->value));
+        ++it; // Skip identifier
+
+        if(it->type != TOKEN_KEYWORD_IN)
+        {
+            return parserError("Invalid foreach statement: expected 'in' "
+                               "after '{}', got '{}'",
+                               iterator->value, it->value);
+        }
+        ++it; // Skip 'in'
+
+        // Range beginning is optional
+        auto begin = parseExpression();
+        if(!begin)
+        {
+            return nullptr;
+        }
+        std::unique_ptr<Expr> end = nullptr;
+        if(it->type == TOKEN_PUNCT_COMMA)
+        {
+            ++it; // Skip ','
+            end = parseExpression();
+            if(!end)
+            {
+                return nullptr;
+            }
+        }
+        else
+        {
+            end = std::move(begin);
+            begin = createNode<EmptyExpr>(it);
+        }
+
+        if(it->type == TOKEN_PUNCT_PAREN_CLOSE)
+        {
+            ++it; // Skip ')'
+        }
+
+        // Parse statement
+        auto block = parseStatement();
+        if(!block)
+        {
+            return nullptr;
+        }
+
+        return createNode<ForeachStmt>(iter, std::move(iterator),
+                                       std::move(begin), std::move(end),
+                                       std::move(block));
+    }
+
     std::unique_ptr<AliasStmt> Parser::parseAliasStatement()
     {
         // 'use' alias '=' aliasee ';'
@@ -494,14 +668,11 @@ namespace parser
         }
         ++it; // Skip '='
 
-        if(it->type != TOKEN_IDENTIFIER)
+        auto aliasee = parseTypename();
+        if(!aliasee)
         {
-            return parserError(
-                "Expected identifier after '=', got '{}' instead", it->value);
+            return nullptr;
         }
-        auto aliaseeName = it->value;
-        auto aliasee = createNode<IdentifierExpr>(it, std::move(aliaseeName));
-        ++it; // Skip aliasee
 
         if(it->type != TOKEN_PUNCT_SEMICOLON)
         {
@@ -538,9 +709,11 @@ namespace parser
         }
         ++it; // Skip ':'
 
-        std::string typen = it->value;
-        const auto typeIter = it;
-        ++it; // Skip type
+        auto typeExpr = parseTypename();
+        if(!typeExpr)
+        {
+            return nullptr;
+        }
 
         // Parse possible init expression
         auto init = [&]() -> std::unique_ptr<Expr> {
@@ -558,7 +731,6 @@ namespace parser
             return nullptr;
         }
 
-        auto typeExpr = createNode<IdentifierExpr>(typeIter, std::move(typen));
         auto nameExpr = createNode<IdentifierExpr>(nameIter, std::move(name));
         auto var = createNode<VariableDefinitionExpr>(
             iter, std::move(typeExpr), std::move(nameExpr), std::move(init));
@@ -632,17 +804,11 @@ namespace parser
         {
             ++it; // Skip '->'
 
-            if(it->type != TOKEN_IDENTIFIER)
+            auto returnType = parseTypename();
+            if(!returnType)
             {
-                return parserError(
-                    "Invalid function prototype: expected "
-                    "identifier in return type, got '{}' instead",
-                    it->value);
+                return nullptr;
             }
-            auto idvalue = it->value;
-            auto returnType =
-                createNode<IdentifierExpr>(it, std::move(idvalue));
-            ++it; // Skip identifier
 
             auto fnName = funcName->value;
             auto proto = createNode<FunctionPrototypeStmt>(
@@ -652,6 +818,8 @@ namespace parser
             {
                 proto->isMain = true;
             }
+            proto->attributes = std::move(functionAttributes);
+            functionAttributes.clear();
             return proto;
         }
         auto fnName = funcName->value;
@@ -663,6 +831,8 @@ namespace parser
         {
             proto->isMain = true;
         }
+        proto->attributes = std::move(functionAttributes);
+        functionAttributes.clear();
         return proto;
     }
 
@@ -709,10 +879,15 @@ namespace parser
     std::unique_ptr<ReturnStmt> Parser::parseReturnStatement()
     {
         const auto iter = it;
-        ++it; // Skip return
+        const bool become = it->type == TOKEN_KEYWORD_BECOME;
+        ++it; // Skip return or become
 
         if(it->type == TOKEN_PUNCT_SEMICOLON)
         {
+            if(become)
+            {
+                return parserError("Expected a function call after 'become'");
+            }
             ++it; // Skip ';'
             return createNode<ReturnStmt>(iter, createNode<EmptyExpr>(iter));
         }
@@ -725,12 +900,12 @@ namespace parser
         if(it->type != TOKEN_PUNCT_SEMICOLON)
         {
             return parserError(
-                "Expected ';' after return statement, got '{}' instead",
-                it->value);
+                "Expected ';' after {} statement, got '{}' instead",
+                become ? "become" : "return", it->value);
         }
         ++it; // Skip ';'
 
-        return createNode<ReturnStmt>(iter, std::move(expr));
+        return createNode<ReturnStmt>(iter, std::move(expr), become);
     }
 
     std::unique_ptr<ExprStmt> Parser::createExprStmt(std::unique_ptr<Expr> expr)
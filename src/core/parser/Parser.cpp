@@ -27,6 +27,48 @@ namespace parser
         parentSolver->run<BlockStmt>(ast->globalNode.get());
     }
 
+    std::unique_ptr<ast::Expr> Parser::runInteractive()
+    {
+        switch(it->type.get())
+        {
+        case TOKEN_EOF:
+        case TOKEN_PUNCT_SEMICOLON:
+        case TOKEN_KEYWORD_IMPORT:
+        case TOKEN_KEYWORD_MODULE:
+        case TOKEN_KEYWORD_DEFINE:
+        case TOKEN_KEYWORD_LET:
+        case TOKEN_KEYWORD_EXPORT:
+        case TOKEN_KEYWORD_USE:
+        case TOKEN_KEYWORD_CONST:
+        case TOKEN_PUNCT_AT:
+            run();
+            return nullptr;
+        default:
+            break;
+        }
+
+        // An expression, optionally followed by a ';'
+        auto expr = parseExpression();
+        if(!expr)
+        {
+            error = ERROR_ERROR;
+            return nullptr;
+        }
+        if(it->type == TOKEN_PUNCT_SEMICOLON)
+        {
+            ++it;
+        }
+        if(it->type != TOKEN_EOF)
+        {
+            return parserError(it, "Unexpected token after expression: '{}'",
+                               it->value);
+        }
+
+        auto parentSolver = std::make_unique<ParentSolverVisitor>();
+        parentSolver->run<Expr>(expr.get());
+        return expr;
+    }
+
     void Parser::_runParser()
     {
         while(true)
@@ -77,6 +119,14 @@ namespace parser
             case TOKEN_KEYWORD_USE:
                 handleUse();
                 break;
+            // Compile-time evaluated symbol
+            case TOKEN_KEYWORD_CONST:
+                handleConst();
+                break;
+            // Function attributes
+            case TOKEN_PUNCT_AT:
+                handleAttributes();
+                break;
 
             // Unsupported top-level token
             default:
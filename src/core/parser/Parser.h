@@ -33,6 +33,13 @@ namespace parser
 
         /// Run the parser
         void run();
+        /**
+         * Run the parser on a line of interactive input.
+         * Top-level items are added to the AST,
+         * anything else is parsed as a single expression.
+         * \return Parsed expression, or nullptr if the input wasn't one
+         */
+        std::unique_ptr<ast::Expr> runInteractive();
 
         bool getError() const;
         ErrorLevel getErrorLevel() const;
@@ -107,9 +114,13 @@ namespace parser
 
         std::unique_ptr<ast::ImportStmt> parseImportStatement();
         std::unique_ptr<ast::IfStmt> parseIfStatement();
+        bool parseAttributes(std::vector<ast::Attribute>& attributes);
+        std::unique_ptr<ast::Stmt> parseAttributedStatement();
         std::unique_ptr<ast::ForStmt> parseForStatement();
+        std::unique_ptr<ast::ForeachStmt> parseForeachStatement();
         std::unique_ptr<ast::WhileStmt> parseWhileStatement();
         std::unique_ptr<ast::VariableDefinitionExpr> parseVariableDefinition();
+        std::unique_ptr<ast::IdentifierExpr> parseTypename();
         std::unique_ptr<ast::GlobalVariableDefinitionExpr>
         parseGlobalVariableDefinition();
         std::unique_ptr<ast::ModuleStmt> parseModuleStatement();
@@ -141,6 +152,8 @@ namespace parser
         void handleGlobalVariable();
         void handleExport();
         void handleUse();
+        void handleConst();
+        void handleAttributes();
 
         std::unique_ptr<ast::Stmt> parseStatement();
         std::unique_ptr<ast::BlockStmt> parseBlockStatement();
@@ -161,6 +174,10 @@ namespace parser
         lexer::TokenVector::const_iterator it;
         const lexer::TokenVector::const_iterator endTokens;
 
+        /// Function attributes parsed by handleAttributes(),
+        /// consumed by parseFunctionPrototype()
+        std::vector<ast::Attribute> functionAttributes;
+
         ErrorLevel error;
 
         std::shared_ptr<util::File> file;
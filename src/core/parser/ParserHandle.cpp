@@ -102,6 +102,13 @@ namespace parser
             mangle = false;
         }
 
+        bool isConst = false;
+        if(it->type == TOKEN_KEYWORD_CONST)
+        {
+            ++it; // Skip 'const'
+            isConst = true;
+        }
+
         if(it->type == TOKEN_KEYWORD_LET)
         {
             auto expr = parseGlobalVariableDefinition();
@@ -111,6 +118,7 @@ namespace parser
             }
 
             expr->isExport = true;
+            expr->isConst = isConst;
 
             util::logger->trace("Parsed global variable definition: name: "
                                 "'{}', type: '{}', isMutable: '{}'",
@@ -130,6 +138,7 @@ namespace parser
 
             def->proto->isExport = true;
             def->proto->mangle = mangle;
+            def->proto->isConst = isConst;
 
             util::logger->trace("Parsed function definition: name: '{}', "
                                 "return: '{}', params.size: '{}'",
@@ -145,6 +154,98 @@ namespace parser
         }
     }
 
+    void Parser::handleConst()
+    {
+        ++it; // Skip 'const'
+
+        if(it->type == TOKEN_KEYWORD_LET)
+        {
+            auto expr = parseGlobalVariableDefinition();
+            if(!expr)
+            {
+                return;
+            }
+
+            expr->isConst = true;
+
+            util::logger->trace("Parsed constant global variable definition: "
+                                "name: '{}', type: '{}'",
+                                expr->var->name->value,
+                                expr->var->typeInferred ? expr->var->type->value
+                                                        : "(will be inferred)");
+            getAST().push(createExprStmt(std::move(expr)));
+        }
+        else if(it->type == TOKEN_KEYWORD_DEFINE)
+        {
+            auto def = parseFunctionDefinitionStatement();
+            if(!def)
+            {
+                return;
+            }
+
+            def->proto->isConst = true;
+
+            util::logger->trace("Parsed constant function definition: name: "
+                                "'{}', return: '{}', params.size: '{}'",
+                                def->proto->name->value,
+                                def->proto->returnType->value,
+                                def->proto->params.size());
+            getAST().push(std::move(def));
+        }
+        else
+        {
+            parserError(it, "Unexpected token after 'const': '{}'", it->value);
+            ++it;
+        }
+    }
+
+    void Parser::handleAttributes()
+    {
+        const auto iter = it;
+        if(!parseAttributes(functionAttributes))
+        {
+            functionAttributes.clear();
+            ++it;
+            return;
+        }
+
+        // Attributes are followed by a function definition,
+        // optionally prefixed by 'export [nomangle] [const]' or 'const'
+        auto def = it;
+        while(def->type == TOKEN_KEYWORD_EXPORT ||
+              def->type == TOKEN_KEYWORD_NO_MANGLE ||
+              def->type == TOKEN_KEYWORD_CONST)
+        {
+            ++def;
+        }
+        if(def->type != TOKEN_KEYWORD_DEFINE)
+        {
+            functionAttributes.clear();
+            parserError(iter, "Attributes are only allowed on functions");
+            return;
+        }
+
+        switch(it->type.get())
+        {
+        case TOKEN_KEYWORD_EXPORT:
+            handleExport();
+            break;
+        case TOKEN_KEYWORD_CONST:
+            handleConst();
+            break;
+        case TOKEN_KEYWORD_DEFINE:
+            handleDef();
+            break;
+        default:
+            parserError(it, "Unexpected token after attributes: '{}'",
+                        it->value);
+            ++it;
+            break;
+        }
+        // Not consumed if parsing failed
+        functionAttributes.clear();
+    }
+
     void Parser::handleUse()
     {
         if(auto stmt = parseAliasStatement())
@@ -0,0 +1,222 @@
+// Copyright (C) 2016-2017 Elias Kosunen
+// This file is distributed under the 3-Clause BSD License
+// See LICENSE for details
+
+#include "codegen/LTOLinker.h"
+#include "codegen/ModuleFile.h"
+#include "codegen/ReplSession.h"
+#include <doctest.h>
+#include <cstdint>
+#include <string>
+
+using namespace codegen;
+
+static ModuleFile::ModuleFileSymbolTable createSymbols(size_t count)
+{
+    ModuleFile::ModuleFileSymbolTable table;
+    for(size_t i = 0; i < count; ++i)
+    {
+        if(i % 2 == 0)
+        {
+            auto f = std::make_unique<ModuleFile::ModuleFileFunctionSymbol>();
+            f->name = "function" + std::to_string(i);
+            f->typeName = "(i32, f64) -> i32";
+            f->retTypeName = "i32";
+            f->paramTypeNames = {"i32", "f64"};
+            f->mangle = i % 4 == 0;
+            table.symbols.push_back(std::move(f));
+        }
+        else
+        {
+            auto v = std::make_unique<ModuleFile::ModuleFileSymbol>();
+            v->name = "variable" + std::to_string(i);
+            v->typeName = "i64";
+            v->isMutable = true;
+            table.symbols.push_back(std::move(v));
+        }
+        table.symbols.back()->loc.line = static_cast<uint32_t>(i + 1);
+    }
+    return table;
+}
+
+static std::unique_ptr<ModuleFileView>
+createView(const ModuleFile::ModuleFileSymbolTable& table)
+{
+    return ModuleFileView::create(
+        llvm::MemoryBuffer::getMemBufferCopy(ModuleFile::encode(table)));
+}
+
+TEST_CASE("Module file index")
+{
+    const auto table = createSymbols(100);
+    auto view = createView(table);
+    REQUIRE(view->size() == 100);
+
+    auto f = view->find("function42");
+    REQUIRE(f);
+    CHECK(f.isFunction());
+    CHECK(f.getName() == "function42");
+    CHECK(f.getReturnTypeName() == "i32");
+    REQUIRE(f.getParamCount() == 2);
+    CHECK(f.getParamTypeName(0) == "i32");
+    CHECK(f.getParamTypeName(1) == "f64");
+    CHECK_FALSE(f.isMangled());
+    CHECK(f.getLocation().line == 43);
+
+    auto v = view->find("variable99");
+    REQUIRE(v);
+    CHECK_FALSE(v.isFunction());
+    CHECK(v.isMutable());
+    CHECK(v.getTypeName() == "i64");
+
+    CHECK_FALSE(view->find("function1"));
+    CHECK_FALSE(view->find(""));
+}
+
+TEST_CASE("Module file round trip")
+{
+    const auto table = createSymbols(7);
+    const auto decoded = createView(table)->toSymbolTable();
+    REQUIRE(decoded.symbols.size() == table.symbols.size());
+    for(size_t i = 0; i < table.symbols.size(); ++i)
+    {
+        CHECK(decoded.symbols[i]->name == table.symbols[i]->name);
+        CHECK(decoded.symbols[i]->typeName == table.symbols[i]->typeName);
+        CHECK(decoded.symbols[i]->isFunction() ==
+              table.symbols[i]->isFunction());
+    }
+}
+
+TEST_CASE("Module file function attributes")
+{
+    auto table = createSymbols(3);
+    auto f = static_cast<ModuleFile::ModuleFileFunctionSymbol*>(
+        table.symbols[2].get());
+    f->attributes = FunctionSymbol::ATTR_INLINE | FunctionSymbol::ATTR_CONST;
+
+    auto view = createView(table);
+    auto e = view->find("function2");
+    REQUIRE(e);
+    CHECK(e.getAttributes() == f->attributes);
+    CHECK(e.isFunction());
+    CHECK(view->find("function0").getAttributes() == 0);
+
+    const auto decoded = view->toSymbolTable();
+    CHECK(static_cast<ModuleFile::ModuleFileFunctionSymbol*>(
+              decoded.symbols[2].get())
+              ->attributes == f->attributes);
+}
+
+TEST_CASE("Empty module file")
+{
+    auto view = createView(ModuleFile::ModuleFileSymbolTable{});
+    CHECK(view->size() == 0);
+    CHECK_FALSE(view->find("main"));
+}
+
+TEST_CASE("Module file bitcode")
+{
+    CHECK(createView(createSymbols(3))->getBitcode().empty());
+
+    const std::string bitcode("BC\xC0\xDE\0\x01\x02\x03", 8);
+    auto view = ModuleFileView::create(llvm::MemoryBuffer::getMemBufferCopy(
+        ModuleFile::encode(createSymbols(5), bitcode)));
+    CHECK(view->getBitcode() == bitcode);
+    CHECK(reinterpret_cast<uintptr_t>(view->getBitcode().data()) % 4 == 0);
+    CHECK(view->find("function4"));
+}
+
+TEST_CASE("Invalid module file")
+{
+    CHECK_THROWS_AS(ModuleFileView::create(llvm::MemoryBuffer::getMemBufferCopy(
+                        "not a module file")),
+                    std::runtime_error);
+
+    auto data = ModuleFile::encode(createSymbols(3));
+    data.resize(data.size() - 8);
+    CHECK_THROWS_AS(
+        ModuleFileView::create(llvm::MemoryBuffer::getMemBufferCopy(data)),
+        std::runtime_error);
+}
+
+static ModuleSummary::GlobalSummary
+createFunctionSummary(std::string name, bool exported, uint32_t size,
+                      std::vector<std::string> calls = {},
+                      std::vector<std::string> refs = {})
+{
+    ModuleSummary::GlobalSummary s;
+    s.name = std::move(name);
+    s.isFunction = true;
+    s.isExported = exported;
+    s.instCount = size;
+    s.calls = std::move(calls);
+    s.refs = std::move(refs);
+    return s;
+}
+
+TEST_CASE("ThinLTO imports")
+{
+    std::vector<ModuleSummary> summaries(2);
+    summaries[0].globals.push_back(
+        createFunctionSummary("main", true, 10, {"small", "large", "local"}));
+    summaries[1].globals.push_back(
+        createFunctionSummary("small", true, 5, {"smaller"}));
+    summaries[1].globals.push_back(createFunctionSummary("smaller", true, 5));
+    summaries[1].globals.push_back(createFunctionSummary(
+        "large", true, ThinLTOLinker::importInstrLimit + 1));
+    summaries[1].globals.push_back(
+        createFunctionSummary("local", true, 5, {}, {".str"}));
+    ModuleSummary::GlobalSummary str;
+    str.name = ".str";
+    summaries[1].globals.push_back(str);
+
+    const auto imports = ThinLTOLinker::computeImports(summaries);
+    REQUIRE(imports.size() == 2);
+    CHECK(imports[1].empty());
+    REQUIRE(imports[0].count(1) == 1);
+    const auto& list = imports[0].at(1);
+    CHECK(list.count("small") == 1);
+    // Transitively called
+    CHECK(list.count("smaller") == 1);
+    // Too large
+    CHECK(list.count("large") == 0);
+    // Refers to a local symbol
+    CHECK(list.count("local") == 0);
+}
+
+TEST_CASE("REPL session")
+{
+    ReplSession session(0, 0);
+    REQUIRE(session.eval("def square(x: i32) -> i32 { return x * x; }"));
+    REQUIRE(
+        session.eval("def twice(x: i32) -> i32 { return square(x) * 2; }"));
+    REQUIRE(session.eval("twice(3)"));
+    CHECK(session.getResult() == "18: i32");
+
+    // Callers compiled earlier call the new definition
+    REQUIRE(session.eval("def square(x: i32) -> i32 { return x + x; }"));
+    REQUIRE(session.eval("twice(3)"));
+    CHECK(session.getResult() == "12: i32");
+
+    REQUIRE(session.eval("let answer = 42;"));
+    REQUIRE(session.eval("answer"));
+    CHECK(session.getResult() == "42: i32");
+
+    // Nothing from a failed input is kept
+    CHECK_FALSE(session.eval("def broken() -> i32 { return missing; }"));
+    CHECK_FALSE(session.eval("broken()"));
+
+    // The session keeps working after a failed input
+    REQUIRE(session.eval("def cube(x: i32) -> i32 { return x * square(x); }"));
+    REQUIRE(session.eval("cube(answer - 39)"));
+    CHECK(session.getResult() == "18: i32");
+
+    // Modules rejected by the JIT are rolled back too
+    REQUIRE(session.eval("def varuna_undefined_extern() -> i32;"));
+    CHECK_FALSE(session.eval(
+        "def call_extern() -> i32 { return varuna_undefined_extern(); }"));
+    CHECK_FALSE(session.eval("call_extern()"));
+    REQUIRE(session.eval("def call_extern() -> i32 { return 7; }"));
+    REQUIRE(session.eval("call_extern()"));
+    CHECK(session.getResult() == "7: i32");
+}
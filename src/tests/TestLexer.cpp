@@ -399,4 +399,23 @@ TEST_CASE("Test lexer")
         CHECK(v.at(13).type == TOKEN_LITERAL_FALSE);
         CHECK(v.at(14).type == TOKEN_PUNCT_SEMICOLON);
     }
+    SUBCASE("Attributes")
+    {
+        f->setContent("@unroll(4) @nounroll while");
+        Lexer l(f);
+        v = l.run();
+        CHECK(v.size() == 9);
+        CHECK(!l.getError());
+
+        CHECK(v.at(0).type == TOKEN_PUNCT_AT);
+        CHECK(v.at(1).type == TOKEN_IDENTIFIER);
+        CHECK(v.at(1).value == "unroll");
+        CHECK(v.at(2).type == TOKEN_PUNCT_PAREN_OPEN);
+        CHECK(v.at(3).type == TOKEN_LITERAL_INTEGER);
+        CHECK(v.at(4).type == TOKEN_PUNCT_PAREN_CLOSE);
+        CHECK(v.at(5).type == TOKEN_PUNCT_AT);
+        CHECK(v.at(6).type == TOKEN_IDENTIFIER);
+        CHECK(v.at(6).value == "nounroll");
+        CHECK(v.at(7).type == TOKEN_KEYWORD_WHILE);
+    }
 }
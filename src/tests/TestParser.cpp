@@ -2,6 +2,7 @@
 // This file is distributed under the 3-Clause BSD License
 // See LICENSE for details
 
+#include "ast/FunctionStmt.h"
 #include "core/lexer/Lexer.h"
 #include "core/parser/Parser.h"
 #include "util/File.h"
@@ -45,4 +46,21 @@ TEST_CASE("Test parser")
         CHECK(root->nodes.size() == 0);
         CHECK(!p.getError());
     }
+
+    SUBCASE("Function attributes")
+    {
+        auto p = parse("@inline @const export def f() {}");
+        CHECK(!p.getError());
+        auto ast = p.retrieveAST();
+        REQUIRE(ast->globalNode->nodes.size() == 1);
+        auto def = dynamic_cast<ast::FunctionDefinitionStmt*>(
+            ast->globalNode->nodes[0].get());
+        REQUIRE(def);
+        CHECK(def->proto->isExport);
+        REQUIRE(def->proto->attributes.size() == 2);
+        CHECK(def->proto->attributes[0].name == "inline");
+        CHECK(def->proto->attributes[1].name == "const");
+
+        CHECK(parse("@inline let a = 0;").getError());
+    }
 }
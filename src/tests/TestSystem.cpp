@@ -4,11 +4,19 @@
 
 #include "util/File.h"
 #include "util/Logger.h"
+#include "util/Platform.h"
 #include "util/Process.h"
 #include "util/ProgramInfo.h"
 #include "util/StringUtils.h"
 #include <doctest.h>
+#include <chrono>
+#include <cstdio>
 #include <cstdlib>
+#include <thread>
+
+#if !VARUNA_WIN32
+#include <sys/stat.h>
+#endif
 
 using namespace fmt::literals;
 
@@ -222,6 +230,7 @@ TEST_CASE("04_arithmetic")
 {
     runEmitLLVM("04_arithmetic.va", "04_arithmetic.ll", "-O0");
     runEmitLLVM("04_arithmetic.va", "04_arithmetic_opt.ll", "-O3");
+    runEmitLLVM("04_arithmetic.va", "04_arithmetic_wrapv.ll", "-O0 -fwrapv");
 }
 
 TEST_CASE("05_variables")
@@ -288,21 +297,391 @@ TEST_CASE("14_modules")
     runEmitLLVMWithModules("14_modules.va", "14_modules_opt.ll", "-O3");
 }
 
+TEST_CASE("15_lazy_import")
+{
+    // Uses the module file of 14_modules_importee
+    runEmitLLVMWithModules("15_lazy_import.va", "15_lazy_import.ll", "-O0");
+    runEmitLLVMWithModules("15_lazy_import.va", "15_lazy_import_opt.ll",
+                           "-O3");
+}
+
+static bool hasTool(const std::string& tool)
+{
+    auto p = util::Process(tool, "--version");
+    return p.spawn() && p.getReturnValue() == 0;
+}
+
+static void spawn(const std::string& file, const std::string& args)
+{
+    auto p = util::Process(file, args);
+    CHECK(p.spawn());
+    REQUIRE(p.getReturnValue() == 0);
+}
+
+/**
+ * Compile a test input into LLVM IR
+ * \param  inputFilename  Input file in inputs/
+ * \param  outputFilename Output file in outputs/
+ * \param  flags          Compiler flags
+ * \return                Generated LLVM IR
+ */
+static std::string emitLLVM(const std::string& inputFilename,
+                            const std::string& outputFilename,
+                            const std::string& flags = "-O0")
+{
+    const auto out = fmt::format("{dir}/src/tests/outputs/{out}",
+                                 "dir"_a = dir(), "out"_a = outputFilename);
+    spawn(fmt::format("{}/bin/varuna", dir()),
+          fmt::format("-no-module -strip-debug -strip-source-filename "
+                      "-logging=warning {flags} -emit=llvm-ir "
+                      "{dir}/src/tests/inputs/{in} -o {out}",
+                      "flags"_a = flags, "dir"_a = dir(),
+                      "in"_a = inputFilename, "out"_a = out));
+    util::File output(out);
+    REQUIRE(output.readFile());
+    return output.consumeContent();
+}
+
+/**
+ * Run a test input with -run, with and without optimizations.
+ * main of every such input returns 42
+ * \param inputFilename Input file in inputs/
+ * \param flags         Compiler flags
+ */
+static void runExpectResult(const std::string& inputFilename,
+                            const std::string& flags = "")
+{
+    for(const auto& opt : {"-O0", "-O2"})
+    {
+        auto p = util::Process(
+            fmt::format("{}/bin/varuna", dir()),
+            fmt::format("-no-module -logging=warning{flags} -run {opt} "
+                        "{dir}/src/tests/inputs/{in}",
+                        "flags"_a = (flags.empty() ? "" : (" " + flags)),
+                        "opt"_a = opt, "dir"_a = dir(),
+                        "in"_a = inputFilename));
+        CHECK(p.spawn());
+        CHECK(p.getReturnValue() == 42);
+    }
+}
+
+TEST_CASE("16_pgo")
+{
+    // Linking with the profiling runtime requires clang and llvm-profdata
+    if(!hasTool("clang") || !hasTool("llvm-profdata"))
+    {
+        MESSAGE("clang or llvm-profdata not found, skipping");
+        return;
+    }
+
+    const auto varuna = fmt::format("{}/bin/varuna", dir());
+    const auto in = fmt::format("{}/src/tests/inputs/16_pgo.va", dir());
+    const auto out = fmt::format("{}/src/tests/outputs/16_pgo", dir());
+
+    // Build an instrumented program and run it
+    spawn(varuna, fmt::format("-no-module -strip-debug -strip-source-filename "
+                              "-logging=warning -O2 -fprofile-generate "
+                              "{in} -o {out}_gen.o",
+                              "in"_a = in, "out"_a = out));
+    spawn("clang", fmt::format("-fprofile-instr-generate {out}_gen.o "
+                               "-o {out}_gen",
+                               "out"_a = out));
+    spawn("env", fmt::format("LLVM_PROFILE_FILE={out}.profraw {out}_gen",
+                             "out"_a = out));
+    spawn("llvm-profdata", fmt::format("merge -o {out}.profdata {out}.profraw",
+                                       "out"_a = out));
+
+    // Re-optimize with the profile
+    spawn(varuna, fmt::format("-no-module -strip-debug -strip-source-filename "
+                              "-logging=warning -O2 -fprofile-use={out}."
+                              "profdata -emit=llvm-ir {in} -o {out}_use.ll",
+                              "in"_a = in, "out"_a = out));
+    util::File output(fmt::format("{}_use.ll", out));
+    REQUIRE(output.readFile());
+    const auto ir = output.consumeContent();
+    CHECK(ir.find("function_entry_count") != std::string::npos);
+    CHECK(ir.find("branch_weights") != std::string::npos);
+}
+
+TEST_CASE("17_run")
+{
+    // The return value of main is the exit code of varuna
+    runExpectResult("17_run.va");
+}
+
+TEST_CASE("18_const_eval")
+{
+    // The initializer of 'answer' is folded into a constant
+    const auto ir = emitLLVM("18_const_eval.va", "18_const_eval.ll");
+    CHECK(ir.find("@answer = internal constant i32 42") != std::string::npos);
+
+    runExpectResult("18_const_eval.va");
+}
+
+TEST_CASE("19_foreach")
+{
+    // The loop variable is a PHI, not a stack variable
+    const auto ir = emitLLVM("19_foreach.va", "19_foreach.ll");
+    CHECK(ir.find("%i = phi i32") != std::string::npos);
+
+    runExpectResult("19_foreach.va");
+}
+
+TEST_CASE("20_arrays")
+{
+    // Subscripts with a variable index are checked,
+    // unless -fno-bounds-check is given
+    {
+        const auto ir = emitLLVM("20_arrays.va", "20_arrays.ll");
+        CHECK(ir.find("bounds.fail") != std::string::npos);
+    }
+    {
+        const auto ir =
+            emitLLVM("20_arrays.va", "20_arrays.ll", "-O0 -fno-bounds-check");
+        CHECK(ir.find("bounds.fail") == std::string::npos);
+    }
+
+    runExpectResult("20_arrays.va");
+}
+
+TEST_CASE("21_simd")
+{
+    const auto ir = emitLLVM("21_simd.va", "21_simd.ll");
+    CHECK(ir.find("fmul <4 x float>") != std::string::npos);
+    CHECK(ir.find("shufflevector <4 x i32>") != std::string::npos);
+
+    runExpectResult("21_simd.va");
+}
+
+TEST_CASE("22_loop_hints")
+{
+    const auto ir = emitLLVM("22_loop_hints.va", "22_loop_hints.ll");
+    CHECK(ir.find("!llvm.loop") != std::string::npos);
+    CHECK(ir.find("llvm.loop.vectorize.width") != std::string::npos);
+    CHECK(ir.find("llvm.loop.interleave.count") != std::string::npos);
+    CHECK(ir.find("llvm.loop.unroll.count") != std::string::npos);
+    CHECK(ir.find("llvm.loop.unroll.disable") != std::string::npos);
+
+    runExpectResult("22_loop_hints.va");
+}
+
+TEST_CASE("23_function_attributes")
+{
+    const auto ir =
+        emitLLVM("23_function_attributes.va", "23_function_attributes.ll");
+    CHECK(ir.find("alwaysinline") != std::string::npos);
+    CHECK(ir.find("noinline") != std::string::npos);
+    CHECK(ir.find("cold") != std::string::npos);
+    CHECK(ir.find("readnone") != std::string::npos);
+    CHECK(ir.find("readonly") != std::string::npos);
+
+    runExpectResult("23_function_attributes.va");
+}
+
+TEST_CASE("24_attribute_inference")
+{
+    const auto ir = emitLLVM("24_attribute_inference.va",
+                             "24_attribute_inference.ll", "-O1");
+    CHECK(ir.find("define internal fastcc") != std::string::npos);
+    CHECK(ir.find("call fastcc") != std::string::npos);
+    CHECK(ir.find("nounwind") != std::string::npos);
+    CHECK(ir.find("norecurse") != std::string::npos);
+    CHECK(ir.find("readnone") != std::string::npos);
+    CHECK(ir.find("readonly") != std::string::npos);
+
+    runExpectResult("24_attribute_inference.va");
+}
+
+TEST_CASE("25_target_cpu")
+{
+    const auto ir = emitLLVM("25_target_cpu.va", "25_target_cpu.ll",
+                             "-O2 -march=native -mattr=-avx512f");
+    CHECK(ir.find("target triple") != std::string::npos);
+    CHECK(ir.find("target datalayout") != std::string::npos);
+    CHECK(ir.find("\"target-cpu\"") != std::string::npos);
+    CHECK(ir.find("-avx512f\"") != std::string::npos);
+
+    runExpectResult("25_target_cpu.va", "-march=native");
+
+    // Only one of them selects the CPU
+    auto p = util::Process(
+        fmt::format("{}/bin/varuna", dir()),
+        fmt::format("-no-module -logging=off -march=native -mcpu=native "
+                    "-emit=none {}/src/tests/inputs/25_target_cpu.va -o -",
+                    dir()));
+    REQUIRE(p.spawn());
+    CHECK_FALSE(p.getReturnValue() == 0);
+}
+
+TEST_CASE("26_unused_definitions")
+{
+    const auto ir =
+        emitLLVM("26_unused_definitions.va", "26_unused_definitions.ll");
+    CHECK(ir.find("@base =") != std::string::npos);
+    CHECK(ir.find("@used(") != std::string::npos);
+    CHECK(ir.find("@exported(") != std::string::npos);
+    CHECK(ir.find("@unused_global") == std::string::npos);
+    CHECK(ir.find("@unused_helper") == std::string::npos);
+    CHECK(ir.find("@unused_function") == std::string::npos);
+
+    runExpectResult("26_unused_definitions.va");
+}
+
+TEST_CASE("27_fast_math")
+{
+    // Only the `@fastmath` function
+    {
+        const auto ir = emitLLVM("27_fast_math.va", "27_fast_math.ll");
+        CHECK(ir.find("fmul fast") != std::string::npos);
+        CHECK(ir.find("\"unsafe-fp-math\"=\"true\"") != std::string::npos);
+        CHECK(ir.find("fadd float") != std::string::npos);
+    }
+    {
+        const auto ir = emitLLVM("27_fast_math.va", "27_fast_math.ll",
+                                 "-O0 -fno-signed-zeros -freciprocal-math");
+        CHECK(ir.find("fadd nsz arcp float") != std::string::npos);
+    }
+    {
+        const auto ir =
+            emitLLVM("27_fast_math.va", "27_fast_math.ll", "-O0 -ffast-math");
+        CHECK(ir.find("fadd float") == std::string::npos);
+        CHECK(ir.find("fadd fast") != std::string::npos);
+    }
+
+    runExpectResult("27_fast_math.va", "-ffast-math");
+}
+
+TEST_CASE("28_overflow")
+{
+    // Overflow-checked arithmetic of 04_arithmetic
+    {
+        const auto ir = emitLLVM("04_arithmetic.va", "04_arithmetic_trapv.ll",
+                                 "-O0 -ftrapv");
+        CHECK(ir.find("@llvm.smul.with.overflow.i32") != std::string::npos);
+        CHECK(ir.find("@llvm.sadd.with.overflow.i32") != std::string::npos);
+        CHECK(ir.find("@llvm.ssub.with.overflow.i32") != std::string::npos);
+        CHECK(ir.find("call void @llvm.trap()") != std::string::npos);
+        CHECK(ir.find(" nsw ") == std::string::npos);
+    }
+
+    runExpectResult("28_overflow.va", "-fwrapv");
+
+    const auto varuna = fmt::format("{}/bin/varuna", dir());
+    const auto in = fmt::format("{}/src/tests/inputs/28_overflow.va", dir());
+    for(const auto& opt : {"-O0", "-O2"})
+    {
+        auto trap = util::Process(
+            varuna, fmt::format("-no-module -logging=warning -ftrapv "
+                                "-run {} {}",
+                                opt, in));
+        CHECK(trap.spawn());
+        CHECK_FALSE(trap.getReturnValue() == 42);
+        CHECK_FALSE(trap.getReturnValue() == 0);
+    }
+
+    // Only one overflow behavior at a time
+    auto p = util::Process(
+        varuna, fmt::format("-no-module -logging=off -fwrapv -ftrapv "
+                            "-emit=none {} -o -",
+                            in));
+    REQUIRE(p.spawn());
+    CHECK_FALSE(p.getReturnValue() == 0);
+}
+
+TEST_CASE("29_short_circuit")
+{
+    const auto ir = emitLLVM("29_short_circuit.va", "29_short_circuit.ll");
+    CHECK(ir.find("and.rhs:") != std::string::npos);
+    CHECK(ir.find("or.rhs:") != std::string::npos);
+    CHECK(ir.find("phi i1") != std::string::npos);
+
+    // An eagerly evaluated rhs would be out of bounds
+    runExpectResult("29_short_circuit.va");
+}
+
+TEST_CASE("30_tail_calls")
+{
+    const auto ir = emitLLVM("30_tail_calls.va", "30_tail_calls.ll");
+    CHECK(ir.find("musttail call i1") != std::string::npos);
+    CHECK(ir.find("tail call i32") != std::string::npos);
+
+    runExpectResult("30_tail_calls.va");
+}
+
+TEST_CASE("31_string_pool")
+{
+    const auto ir = emitLLVM("31_string_pool.va", "31_string_pool.ll");
+
+    auto count = [&](const std::string& str) {
+        size_t n = 0;
+        for(auto pos = ir.find(str); pos != std::string::npos;
+            pos = ir.find(str, pos + 1))
+        {
+            ++n;
+        }
+        return n;
+    };
+    // Both string and cstring literals point to the same constant
+    CHECK(count("c\"Hello\\00\"") == 1);
+    CHECK(count("c\"World\\00\"") == 1);
+    CHECK(count("private unnamed_addr constant") == 2);
+}
+
+#if !VARUNA_WIN32
+TEST_CASE("Compile server")
+{
+    const auto varuna = fmt::format("{}/bin/varuna", dir());
+    const auto socket =
+        fmt::format("{}/src/tests/outputs/server/varuna.sock", dir());
+    std::remove(socket.c_str());
+
+    int serverRet = -1;
+    std::thread server([&]() {
+        auto p = util::Process(
+            varuna, fmt::format("-logging=warning -server -server-socket={}",
+                                socket));
+        if(p.spawn())
+        {
+            serverRet = p.getReturnValue();
+        }
+    });
+    struct stat st;
+    for(int i = 0; i < 100 && ::stat(socket.c_str(), &st) != 0; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    // Options of the first request must not leak into the second one
+    const auto client = fmt::format("-client -server-socket={}", socket);
+    runEmitLLVM("02_main.va", "02_main_opt.ll", "-O3 " + client);
+    runEmitLLVM("03_functions.va", "03_functions.ll", client);
+
+    auto stop = util::Process(
+        varuna, fmt::format("-server-stop -server-socket={}", socket));
+    CHECK(stop.spawn());
+    CHECK(stop.getReturnValue() == 0);
+    server.join();
+    CHECK(serverRet == 0);
+}
+#endif
+
 TEST_SUITE_END();
 
 TEST_SUITE("System tests with expected errors");
 
 static void runExpectError(const std::string& inputFilename,
-                           bool expectException = false)
+                           bool expectException = false,
+                           const std::string& flags = "")
 {
     auto p = util::Process(
         fmt::format("{dir}/bin/varuna", "dir"_a = dir()),
         fmt::format("-no-module -strip-debug -strip-source-filename "
-                    "-logging={log} "
+                    "-logging={log}{flags} "
                     "{dir}/src/tests/error_inputs/{in} "
                     "-o - -emit=none",
                     "dir"_a = dir(), "in"_a = inputFilename,
-                    "log"_a = (expectException ? "off" : "critical")));
+                    "log"_a = (expectException ? "off" : "critical"),
+                    "flags"_a = (flags.empty() ? "" : (" " + flags))));
     REQUIRE(p.spawn());
     CHECK_FALSE(p.getReturnValue() == 0);
 }
@@ -352,4 +731,41 @@ TEST_CASE("09_invalid_import")
     runExpectError("09_invalid_import.va");
 }
 
+TEST_CASE("10_impure_const")
+{
+    runExpectError("10_impure_const.va");
+}
+
+TEST_CASE("11_const_recursion")
+{
+    runExpectError("11_const_recursion.va");
+}
+
+TEST_CASE("12_out_of_bounds")
+{
+    runExpectError("12_out_of_bounds.va");
+    // Constant indices are checked without runtime checks too
+    runExpectError("12_out_of_bounds.va", false, "-fno-bounds-check");
+}
+
+TEST_CASE("13_invalid_loop_hint")
+{
+    runExpectError("13_invalid_loop_hint.va");
+}
+
+TEST_CASE("14_impure_function")
+{
+    runExpectError("14_impure_function.va");
+}
+
+TEST_CASE("15_invalid_become")
+{
+    runExpectError("15_invalid_become.va");
+}
+
+TEST_CASE("16_unused_undefined")
+{
+    runExpectError("16_unused_undefined.va");
+}
+
 TEST_SUITE_END();
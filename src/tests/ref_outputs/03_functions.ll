@@ -5,16 +5,13 @@ declare i32 @_Z11declarationi(i32)
 
 define internal i32 @_Z10definitioni(i32 %arg) {
 entry:
-  %arg1 = alloca i32
-  store i32 %arg, i32* %arg1
-  %arg2 = load i32, i32* %arg1
-  %calltmp = call i32 @_Z11declarationi(i32 %arg2)
+  %calltmp = tail call i32 @_Z11declarationi(i32 %arg)
   ret i32 %calltmp
 }
 
 define i32 @_Z4mainv() {
 entry:
-  %calltmp = call i32 @_Z10definitioni(i32 0)
+  %calltmp = tail call i32 @_Z10definitioni(i32 0)
   ret i32 %calltmp
 }
 
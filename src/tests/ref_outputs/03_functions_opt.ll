@@ -3,12 +3,15 @@ source_filename = "Varuna"
 
 declare i32 @_Z11declarationi(i32) local_unnamed_addr
 
-define i32 @_Z4mainv() local_unnamed_addr {
+; Function Attrs: nounwind
+define i32 @_Z4mainv() local_unnamed_addr #0 {
 entry:
   %calltmp.i = tail call i32 @_Z11declarationi(i32 0)
   ret i32 %calltmp.i
 }
 
+attributes #0 = { nounwind }
+
 !llvm.module.flags = !{!0}
 
 !0 = !{i32 1, !"Debug Info Version", i32 3}
@@ -3,7 +3,8 @@ source_filename = "Varuna"
 
 declare i32 @_Z3numi(i32) local_unnamed_addr
 
-define i32 @_Z4mainv() local_unnamed_addr {
+; Function Attrs: nounwind
+define i32 @_Z4mainv() local_unnamed_addr #0 {
 entry:
   %calltmp = tail call i32 @_Z3numi(i32 1)
   %calltmp1 = tail call i32 @_Z3numi(i32 0)
@@ -18,6 +19,8 @@ entry:
   ret i32 %subtmp
 }
 
+attributes #0 = { nounwind }
+
 !llvm.module.flags = !{!0}
 
 !0 = !{i32 1, !"Debug Info Version", i32 3}
@@ -4,16 +4,13 @@ source_filename = "Varuna"
 define i32 @_Z4mainv() {
 entry:
   %mutable = alloca i32
-  %immutable = alloca i32
-  store i32 1, i32* %immutable
   store i32 2, i32* %mutable
   %mutable1 = load i32, i32* %mutable
   store i32 0, i32* %mutable
   %mutable2 = load i32, i32* %mutable
   store i32 1, i32* %mutable
-  %immutable3 = load i32, i32* %immutable
-  %mutable4 = load i32, i32* %mutable
-  %subtmp = sub nsw i32 %immutable3, %mutable4
+  %mutable3 = load i32, i32* %mutable
+  %subtmp = sub nsw i32 1, %mutable3
   ret i32 %subtmp
 }
 
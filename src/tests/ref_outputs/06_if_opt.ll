@@ -3,7 +3,8 @@ source_filename = "Varuna"
 
 declare i1 @_Z4condv() local_unnamed_addr
 
-define i32 @_Z4mainv() local_unnamed_addr {
+; Function Attrs: nounwind
+define i32 @_Z4mainv() local_unnamed_addr #0 {
 entry:
   %calltmp = tail call i1 @_Z4condv()
   %calltmp1 = tail call i1 @_Z4condv()
@@ -14,6 +15,8 @@ entry:
   ret i32 %merge
 }
 
+attributes #0 = { nounwind }
+
 !llvm.module.flags = !{!0}
 
 !0 = !{i32 1, !"Debug Info Version", i32 3}
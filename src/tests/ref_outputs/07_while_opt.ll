@@ -3,7 +3,8 @@ source_filename = "Varuna"
 
 declare i1 @_Z4condv() local_unnamed_addr
 
-define i32 @_Z4mainv() local_unnamed_addr {
+; Function Attrs: nounwind
+define i32 @_Z4mainv() local_unnamed_addr #0 {
 entry:
   %calltmp3 = tail call i1 @_Z4condv()
   br i1 %calltmp3, label %while.cond1.preheader.preheader, label %while.merge7
@@ -34,6 +35,8 @@ while.merge7:                                     ; preds = %while.merge7.loopex
   ret i32 %a.0.lcssa
 }
 
+attributes #0 = { nounwind }
+
 !llvm.module.flags = !{!0}
 
 !0 = !{i32 1, !"Debug Info Version", i32 3}
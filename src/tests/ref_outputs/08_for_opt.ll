@@ -3,7 +3,8 @@ source_filename = "Varuna"
 
 declare i32 @_Z5countv() local_unnamed_addr
 
-define i32 @_Z4mainv() local_unnamed_addr {
+; Function Attrs: nounwind
+define i32 @_Z4mainv() local_unnamed_addr #0 {
 entry:
   %calltmp6 = tail call i32 @_Z5countv()
   %letmp7 = icmp slt i32 %calltmp6, 1
@@ -30,6 +31,8 @@ for.merge14:                                      ; preds = %for.merge14.loopexi
   ret i32 %a.0.lcssa
 }
 
+attributes #0 = { nounwind }
+
 !llvm.module.flags = !{!0}
 
 !0 = !{i32 1, !"Debug Info Version", i32 3}
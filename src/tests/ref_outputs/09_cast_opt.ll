@@ -3,14 +3,17 @@ source_filename = "Varuna"
 
 declare i32 @_Z3numv() local_unnamed_addr
 
-define i32 @_Z4mainv() local_unnamed_addr {
+; Function Attrs: nounwind
+define i32 @_Z4mainv() local_unnamed_addr #0 {
 entry:
   %calltmp = tail call i32 @_Z3numv()
   %sext = shl i32 %calltmp, 16
-  %casttmp4 = ashr exact i32 %sext, 16
-  ret i32 %casttmp4
+  %casttmp2 = ashr exact i32 %sext, 16
+  ret i32 %casttmp2
 }
 
+attributes #0 = { nounwind }
+
 !llvm.module.flags = !{!0}
 
 !0 = !{i32 1, !"Debug Info Version", i32 3}
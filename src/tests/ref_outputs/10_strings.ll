@@ -3,21 +3,21 @@ source_filename = "Varuna"
 
 %string = type { i64, i8* }
 
-@.str = internal constant [12 x i8] c"Hello world!"
-@.str.1 = internal constant [12 x i8] c"Hei maailma!"
+@.str = private unnamed_addr constant [13 x i8] c"Hello world!\00", align 1
+@.str.1 = private unnamed_addr constant [13 x i8] c"Hei maailma!\00", align 1
 
 declare i32 @_Z4func6string(%string)
 
 define i32 @_Z4mainv() {
 entry:
   %s = alloca %string
-  store %string { i64 12, i8* getelementptr inbounds ([12 x i8], [12 x i8]* @.str, i32 0, i32 0) }, %string* %s
+  store %string { i64 12, i8* getelementptr inbounds ([13 x i8], [13 x i8]* @.str, i32 0, i32 0) }, %string* %s
   %s1 = load %string, %string* %s
   %calltmp = call i32 @_Z4func6string(%string %s1)
   %s2 = load %string, %string* %s
-  store %string { i64 12, i8* getelementptr inbounds ([12 x i8], [12 x i8]* @.str.1, i32 0, i32 0) }, %string* %s
+  store %string { i64 12, i8* getelementptr inbounds ([13 x i8], [13 x i8]* @.str.1, i32 0, i32 0) }, %string* %s
   %s3 = load %string, %string* %s
-  %calltmp4 = call i32 @_Z4func6string(%string %s3)
+  %calltmp4 = tail call i32 @_Z4func6string(%string %s3)
   ret i32 %calltmp4
 }
 
@@ -5,10 +5,7 @@ declare i32 @_Z4funci(i32)
 
 define i32 @_Z4mainv() {
 entry:
-  %n = alloca i32
-  store i32 10, i32* %n
-  %n1 = load i32, i32* %n
-  %calltmp = call i32 @_Z4funci(i32 %n1)
+  %calltmp = tail call i32 @_Z4funci(i32 10)
   ret i32 %calltmp
 }
 
@@ -7,17 +7,14 @@ declare i32 @_Z3chri(i32)
 
 define i32 @_Z4mainv() {
 entry:
-  %smile = alloca i32
   %c = alloca i32
   store i32 97, i32* %c
   %c1 = load i32, i32* %c
   store i32 228, i32* %c
-  store i32 128512, i32* %smile
-  %smile2 = load i32, i32* %smile
-  %calltmp = call i32 @_Z3ascDi(i32 %smile2)
-  %c3 = load i32, i32* %c
-  %calltmp4 = call i32 @_Z3ascDi(i32 %c3)
-  %divtmp = sdiv i32 %calltmp, %calltmp4
+  %calltmp = call i32 @_Z3ascDi(i32 128512)
+  %c2 = load i32, i32* %c
+  %calltmp3 = call i32 @_Z3ascDi(i32 %c2)
+  %divtmp = sdiv i32 %calltmp, %calltmp3
   ret i32 %divtmp
 }
 
@@ -3,14 +3,17 @@ source_filename = "Varuna"
 
 declare i32 @_Z3ascDi(i32) local_unnamed_addr
 
-define i32 @_Z4mainv() local_unnamed_addr {
+; Function Attrs: nounwind
+define i32 @_Z4mainv() local_unnamed_addr #0 {
 entry:
   %calltmp = tail call i32 @_Z3ascDi(i32 128512)
-  %calltmp4 = tail call i32 @_Z3ascDi(i32 228)
-  %divtmp = sdiv i32 %calltmp, %calltmp4
+  %calltmp3 = tail call i32 @_Z3ascDi(i32 228)
+  %divtmp = sdiv i32 %calltmp, %calltmp3
   ret i32 %divtmp
 }
 
+attributes #0 = { nounwind }
+
 !llvm.module.flags = !{!0}
 
 !0 = !{i32 1, !"Debug Info Version", i32 3}
@@ -7,8 +7,6 @@ source_filename = "Varuna"
 define i32 @_Z4mainv() {
 entry:
   %local_variable = alloca i32
-  %local_constant = alloca i32
-  store i32 3, i32* %local_constant
   store i32 4, i32* %local_variable
   %variable = load i32, i32* @variable
   store i32 5, i32* @variable
@@ -1,10 +1,6 @@
 ; ModuleID = 'varuna_tmp_input_noopt-a25f4fc8-e968-4d7e-b206-55b4c33c52f5.ll'
 source_filename = "Varuna"
 
-declare i32 @_Z17external_functionv()
-
-declare i32 @_Z16another_functionv()
-
 define i32 @_Z4mainv() {
 entry:
   %b = alloca i32
@@ -25,6 +21,10 @@ entry:
   ret i32 %addtmp
 }
 
+declare i32 @_Z17external_functionv()
+
+declare i32 @_Z16another_functionv()
+
 !llvm.module.flags = !{!0}
 
 !0 = !{i32 1, !"Debug Info Version", i32 3}
@@ -0,0 +1,14 @@
+; ModuleID = 'varuna_tmp_input_noopt-7c1e0d52-3b8a-4f6e-9d2a-5e8b1f4c6a93.ll'
+source_filename = "Varuna"
+
+define i32 @_Z4mainv() {
+entry:
+  %calltmp = tail call i32 @_Z16another_functionv()
+  ret i32 %calltmp
+}
+
+declare i32 @_Z16another_functionv()
+
+!llvm.module.flags = !{!0}
+
+!0 = !{i32 1, !"Debug Info Version", i32 3}
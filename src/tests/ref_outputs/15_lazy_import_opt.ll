@@ -0,0 +1,14 @@
+; ModuleID = 'varuna_tmp_input_noopt-0b9f6e2d-81a4-4c57-a3e0-d26f7c9b45e1.ll'
+source_filename = "Varuna"
+
+; Function Attrs: norecurse nounwind readnone
+define i32 @_Z4mainv() local_unnamed_addr #0 {
+entry:
+  ret i32 -89
+}
+
+attributes #0 = { norecurse nounwind readnone }
+
+!llvm.module.flags = !{!0}
+
+!0 = !{i32 1, !"Debug Info Version", i32 3}
@@ -1,6 +1,8 @@
 #!/bin/bash
 
-for filename in ../inputs/*.va; do
+# Inputs from 16 on are checked by the system tests directly,
+# without reference outputs
+for filename in ../inputs/0*.va ../inputs/1[0-5]_*.va; do
     name=${filename##*/}
     base=${name%.va}
     if [[ ${base} == *module* ]]; then
@@ -11,3 +13,6 @@ for filename in ../inputs/*.va; do
         ../../../bin/varuna ${filename} -o ${base}_opt.ll -O3 -emit=llvm-ir -no-module -strip-debug -strip-source-filename
     fi
 done
+
+# Overflow behaviors
+../../../bin/varuna ../inputs/04_arithmetic.va -o 04_arithmetic_wrapv.ll -O0 -fwrapv -emit=llvm-ir -no-module -strip-debug -strip-source-filename
@@ -70,7 +70,8 @@ enum _OperatorType
     PUNCT_COLON,            ///< :
     PUNCT_SEMICOLON,        ///< ;
     PUNCT_COMMA,            ///< ,
-    PUNCT_ARROW             ///< ->
+    PUNCT_ARROW,            ///< ->
+    PUNCT_AT                ///< @
 };
 
 using OperatorType = util::SafeEnum<_OperatorType>;
@@ -23,6 +23,7 @@ std::pair<uint8_t, uint8_t> ProgramOptions::getOptLevel() const
         o = 2;
         break;
     case OPT_O3:
+    case OPT_Omax:
         o = 3;
         break;
     case OPT_Os:
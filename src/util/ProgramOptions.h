@@ -19,8 +19,8 @@ enum OptimizationLevel
     OPT_O2,     ///< -O2
     OPT_O3,     ///< -O3
     OPT_Os,     ///< -Os
-    OPT_Oz      ///< -Oz
-    // OPT_Omax    ///< -O3 + lto
+    OPT_Oz,     ///< -Oz
+    OPT_Omax    ///< -O3 + lto
 };
 
 enum OutputType
@@ -39,6 +39,21 @@ enum X86AsmSyntax
     X86_INTEL ///< Intel syntax: -x86-asm-syntax=intel
 };
 
+/// Fusion of floating-point operations
+enum FPContract
+{
+    FP_CONTRACT_OFF, ///< Never fuse: -ffp-contract=off
+    FP_CONTRACT_FAST ///< Fuse whenever profitable: -ffp-contract=fast
+};
+
+/// Behavior of signed integer arithmetic on overflow
+enum OverflowPolicy
+{
+    OVERFLOW_UNDEFINED, ///< Undefined, optimizer assumes it can't happen
+    OVERFLOW_WRAP,      ///< Wrap around in two's complement: -fwrapv
+    OVERFLOW_TRAP       ///< Abort the program: -ftrapv
+};
+
 /// Program options
 struct ProgramOptions
 {
@@ -64,6 +79,30 @@ struct ProgramOptions
     bool stripDebug{false};
     /// Strip source filename
     bool stripSourceFilename{false};
+    /// Emit bitcode objects for link-time optimization
+    bool lto{false};
+    /// Instrument the program for profiling
+    bool profileGenerate{false};
+    /// Indexed profile data to optimize with, empty if none
+    std::string profileUse{""};
+    /// Compile the program in memory and run it, instead of writing output
+    bool run{false};
+    /// Check array and slice subscripts at runtime
+    bool boundsCheck{true};
+    /// CPU to generate code for, empty for the default of the target
+    std::string targetCPU{""};
+    /// Comma-separated target features ("+avx2,-fma"), empty if none
+    std::string targetFeatures{""};
+    /// Allow floating-point optimizations that ignore IEEE 754 semantics
+    bool fastMath{false};
+    /// Ignore the sign of floating-point zeros
+    bool noSignedZeros{false};
+    /// Allow replacing division with multiplication by the reciprocal
+    bool reciprocalMath{false};
+    /// Fusion of floating-point operations, e.g. into FMA
+    FPContract fpContract{FP_CONTRACT_OFF};
+    /// Signed integer overflow behavior
+    OverflowPolicy overflow{OVERFLOW_UNDEFINED};
 
     /**
      * Get speed and size optimization levels from optLevel
@@ -0,0 +1,329 @@
+// Copyright (C) 2016-2017 Elias Kosunen
+// This file is distributed under the 3-Clause BSD License
+// See LICENSE for details
+
+#include "util/Socket.h"
+#include <fmt.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#if !VARUNA_WIN32
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace util
+{
+constexpr uint32_t Socket::maxMessageCount;
+constexpr uint32_t Socket::maxMessageLength;
+
+Socket::Socket(Socket&& other) noexcept
+    : fd(other.fd), path(std::move(other.path))
+{
+    other.fd = -1;
+    other.path.clear();
+}
+
+Socket& Socket::operator=(Socket&& other) noexcept
+{
+    if(this != &other)
+    {
+        close();
+        fd = other.fd;
+        path = std::move(other.path);
+        other.fd = -1;
+        other.path.clear();
+    }
+    return *this;
+}
+
+Socket::~Socket() noexcept
+{
+    close();
+}
+
+bool Socket::writeMessage(const std::vector<std::string>& msg)
+{
+    // Message format:
+    // uint32 count, then for each string: uint32 length + bytes
+    const auto count = static_cast<uint32_t>(msg.size());
+    if(!write(&count, sizeof(count)))
+    {
+        return false;
+    }
+    for(const auto& str : msg)
+    {
+        const auto len = static_cast<uint32_t>(str.length());
+        if(!write(&len, sizeof(len)))
+        {
+            return false;
+        }
+        if(len > 0 && !write(str.data(), len))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Socket::readMessage(std::vector<std::string>& msg)
+{
+    uint32_t count = 0;
+    if(!readAll(&count, sizeof(count)))
+    {
+        return false;
+    }
+    if(count > maxMessageCount)
+    {
+        return false;
+    }
+    msg.clear();
+    msg.reserve(count);
+    for(uint32_t i = 0; i < count; ++i)
+    {
+        uint32_t len = 0;
+        if(!readAll(&len, sizeof(len)) || len > maxMessageLength)
+        {
+            return false;
+        }
+        std::string str(len, '\0');
+        if(len > 0 && !readAll(&str[0], len))
+        {
+            return false;
+        }
+        msg.push_back(std::move(str));
+    }
+    return true;
+}
+
+bool Socket::readAll(void* data, size_t len)
+{
+    auto ptr = static_cast<char*>(data);
+    while(len > 0)
+    {
+        auto n = read(ptr, len);
+        if(n <= 0)
+        {
+            return false;
+        }
+        ptr += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+#if VARUNA_WIN32
+
+Socket Socket::listen(const std::string&)
+{
+    throw std::runtime_error("Local sockets are not supported on Windows");
+}
+
+Socket Socket::connect(const std::string&)
+{
+    throw std::runtime_error("Local sockets are not supported on Windows");
+}
+
+Socket Socket::accept()
+{
+    throw std::runtime_error("Local sockets are not supported on Windows");
+}
+
+bool Socket::isPeerSameUser() const
+{
+    return false;
+}
+
+bool Socket::write(const void*, size_t)
+{
+    return false;
+}
+
+std::ptrdiff_t Socket::read(void*, size_t)
+{
+    return -1;
+}
+
+void Socket::close()
+{
+}
+
+#else
+
+static sockaddr_un createAddress(const std::string& path)
+{
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if(path.length() >= sizeof(addr.sun_path))
+    {
+        throw std::runtime_error(
+            fmt::format("Socket path too long: '{}'", path));
+    }
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    return addr;
+}
+
+Socket Socket::listen(const std::string& path)
+{
+    auto addr = createAddress(path);
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if(fd == -1)
+    {
+        throw std::runtime_error(fmt::format("Failed to create socket: {}",
+                                             std::strerror(errno)));
+    }
+    // Remove a stale socket left behind by a previous server,
+    // but never anything that isn't ours
+    struct stat st;
+    if(::lstat(path.c_str(), &st) == 0)
+    {
+        if(!S_ISSOCK(st.st_mode) || st.st_uid != ::getuid())
+        {
+            ::close(fd);
+            throw std::runtime_error(fmt::format(
+                "Refusing to replace '{}': not a socket owned by the user",
+                path));
+        }
+        ::unlink(path.c_str());
+    }
+    if(::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == -1)
+    {
+        const auto err = errno;
+        ::close(fd);
+        throw std::runtime_error(fmt::format(
+            "Failed to bind socket '{}': {}", path, std::strerror(err)));
+    }
+    if(::chmod(path.c_str(), S_IRUSR | S_IWUSR) == -1)
+    {
+        const auto err = errno;
+        ::close(fd);
+        ::unlink(path.c_str());
+        throw std::runtime_error(fmt::format(
+            "Failed to set permissions of socket '{}': {}", path,
+            std::strerror(err)));
+    }
+    if(::listen(fd, SOMAXCONN) == -1)
+    {
+        const auto err = errno;
+        ::close(fd);
+        ::unlink(path.c_str());
+        throw std::runtime_error(fmt::format(
+            "Failed to listen on socket '{}': {}", path, std::strerror(err)));
+    }
+    return Socket(fd, path);
+}
+
+Socket Socket::connect(const std::string& path)
+{
+    auto addr = createAddress(path);
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if(fd == -1)
+    {
+        throw std::runtime_error(fmt::format("Failed to create socket: {}",
+                                             std::strerror(errno)));
+    }
+    if(::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == -1)
+    {
+        const auto err = errno;
+        ::close(fd);
+        throw std::runtime_error(fmt::format(
+            "Failed to connect to socket '{}': {}", path, std::strerror(err)));
+    }
+    return Socket(fd);
+}
+
+Socket Socket::accept()
+{
+    while(true)
+    {
+        int client = ::accept(fd, nullptr, nullptr);
+        if(client != -1)
+        {
+            return Socket(client);
+        }
+        if(errno != EINTR)
+        {
+            throw std::runtime_error(fmt::format(
+                "Failed to accept connection: {}", std::strerror(errno)));
+        }
+    }
+}
+
+bool Socket::isPeerSameUser() const
+{
+#ifdef SO_PEERCRED
+    ucred cred;
+    socklen_t len = sizeof(cred);
+    if(::getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &len) == -1)
+    {
+        return false;
+    }
+    return cred.uid == ::getuid();
+#else
+    uid_t uid;
+    gid_t gid;
+    if(::getpeereid(fd, &uid, &gid) == -1)
+    {
+        return false;
+    }
+    return uid == ::getuid();
+#endif
+}
+
+bool Socket::write(const void* data, size_t len)
+{
+    auto ptr = static_cast<const char*>(data);
+    while(len > 0)
+    {
+        auto n = ::write(fd, ptr, len);
+        if(n == -1)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        ptr += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+std::ptrdiff_t Socket::read(void* data, size_t len)
+{
+    while(true)
+    {
+        auto n = ::read(fd, data, len);
+        if(n == -1 && errno == EINTR)
+        {
+            continue;
+        }
+        return n;
+    }
+}
+
+void Socket::close()
+{
+    if(fd == -1)
+    {
+        return;
+    }
+    ::close(fd);
+    fd = -1;
+    if(!path.empty())
+    {
+        ::unlink(path.c_str());
+        path.clear();
+    }
+}
+
+#endif // VARUNA_WIN32
+} // namespace util
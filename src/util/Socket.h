@@ -0,0 +1,125 @@
+// Copyright (C) 2016-2017 Elias Kosunen
+// This file is distributed under the 3-Clause BSD License
+// See LICENSE for details
+
+#pragma once
+
+#include "util/Platform.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace util
+{
+/// Local (Unix domain) stream socket.
+/// Not supported on Windows
+class Socket
+{
+public:
+    Socket() = default;
+
+    Socket(const Socket&) = delete;
+    Socket& operator=(const Socket&) = delete;
+
+    Socket(Socket&& other) noexcept;
+    Socket& operator=(Socket&& other) noexcept;
+
+    ~Socket() noexcept;
+
+    /// Maximum number of strings in a message read with readMessage()
+    static constexpr uint32_t maxMessageCount = 4096;
+    /// Maximum length of a single string in a message
+    static constexpr uint32_t maxMessageLength = 64 * 1024;
+
+    /**
+     * Create a listening socket bound to `path`.
+     * The socket file is only accessible by the current user.
+     * A stale socket owned by the current user at `path` is removed first,
+     * any other existing file is an error.
+     * \throw std::runtime_error On failure
+     * \param  path Socket filename
+     * \return      Listening socket
+     */
+    static Socket listen(const std::string& path);
+    /**
+     * Connect to a listening socket
+     * \throw std::runtime_error On failure
+     * \param  path Socket filename
+     * \return      Connected socket
+     */
+    static Socket connect(const std::string& path);
+
+    /**
+     * Wait for a client to connect.
+     * \throw std::runtime_error On failure
+     * \return Connected socket
+     */
+    Socket accept();
+
+    /**
+     * Write the whole buffer
+     * \param  data Data to write
+     * \param  len  Length of data
+     * \return      Success
+     */
+    bool write(const void* data, size_t len);
+    /**
+     * Read up to `len` bytes
+     * \param  data Buffer to read into
+     * \param  len  Size of the buffer
+     * \return      Bytes read, 0 on EOF, negative on error
+     */
+    std::ptrdiff_t read(void* data, size_t len);
+
+    /**
+     * Write a length-prefixed list of strings
+     * \param  msg Message to write
+     * \return     Success
+     */
+    bool writeMessage(const std::vector<std::string>& msg);
+    /**
+     * Read a list of strings written with writeMessage().
+     * Fails if the message has more than `maxMessageCount` strings
+     * or a string is longer than `maxMessageLength`
+     * \param  msg Message to read into
+     * \return     Success
+     */
+    bool readMessage(std::vector<std::string>& msg);
+
+    /**
+     * Check that the process on the other end of a connected socket
+     * is run by the current user
+     * \return Peer has the same user id
+     */
+    bool isPeerSameUser() const;
+
+    /// Get the underlying file descriptor
+    int getDescriptor() const
+    {
+        return fd;
+    }
+
+    /// Is the socket open
+    bool isOpen() const
+    {
+        return fd != -1;
+    }
+
+    /// Close the socket
+    void close();
+
+private:
+    explicit Socket(int pFd, std::string pPath = "")
+        : fd(pFd), path(std::move(pPath))
+    {
+    }
+
+    bool readAll(void* data, size_t len);
+
+    /// File descriptor
+    int fd{-1};
+    /// Socket filename, only set for listening sockets.
+    /// Removed when the socket is closed
+    std::string path{};
+};
+} // namespace util